@@ -2,6 +2,18 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <ctype.h>
+#include <dirent.h>
 /*******************************************************************************************************/
 // List of Constants
 
@@ -13,6 +25,7 @@
     of minimum length 1 and maximum length 8. (+1 for space)*/
 #define MAX_PROCESS_NAME_LEN 9 
 #define MAX_FILENAME_STRATEGY_LEN 100
+#define MAX_PATH_LEN 1024
 
 /* Initial size of dynamic array storing processes */
 #define INITIAL_PROCESSES 2
@@ -27,862 +40,4727 @@
 #define FIRST_FIT "first-fit"
 #define PAGED "paged"
 #define VIRTUAL "virtual"
+#define BUDDY "buddy"
+#define MEMORY_UNSUPPORTED -1
+#define MEMORY_INFINITE 0
+#define MEMORY_FIRST_FIT 1
+#define MEMORY_PAGED 2
+#define MEMORY_BUDDY 3
 
-/* Memory Constants and Flags */
-#define MEMORY_CAPACITY 2048 // Total Memory in KB
-#define NUM_PAGES 512
-#define PAGE_SIZE 4
+/* Page replacement policies (--replacement). paged memory evicts whole processes in LRU order by default,
+    the others evict single pages: lru from the least recently used process, fifo the longest resident page,
+    clock the first page not used since the hand last passed it, and opt from the process used furthest
+    in the future, offline */
+#define REPLACE_LRU "lru"
+#define REPLACE_FIFO "fifo"
+#define REPLACE_CLOCK "clock"
+#define REPLACE_OPT "opt"
+#define REPLACEMENT_PROCESS 0
+#define REPLACEMENT_LRU 1
+#define REPLACEMENT_FIFO 2
+#define REPLACEMENT_CLOCK 3
+#define REPLACEMENT_OPT 4
+
+/* first-fit slides every block down to make room when no hole fits but enough memory is free,
+    if --compact gives the time charged per KB moved */
+#define NO_COMPACTION -1
+
+/* virtual memory runs a process once this many of its pages are resident, or all if it has fewer */
+#define VIRTUAL_WORKING_SET 4
+
+/* Buddy blocks are 2^order KB, from 1 KB up to the largest a long long address can hold */
+#define BUDDY_ORDERS 62
+
+/* Memory Constants and Flags, the geometry can be changed with --memory and --page-size */
+#define DEFAULT_MEMORY_CAPACITY 2048 // Total Memory in KB
+#define DEFAULT_PAGE_SIZE 4 // Frame size in KB
 #define NOT_ALLOCATED -1
-#define FREE 0
-#define ALLOCATED 1
 
 #define SWITCH 1
 #define CONTINUE 0
 
+/* Scheduling policies (-s), round robin by default */
+#define ROUND_ROBIN "rr"
+#define SHORTEST_JOB_FIRST "sjf"
+#define SHORTEST_REMAINING_TIME "srtf"
+#define PRIORITY_AGING "priority"
+#define MULTILEVEL_FEEDBACK "mlfq"
+#define POLICY_RR 0
+#define POLICY_SJF 1
+#define POLICY_SRTF 2
+#define POLICY_PRIORITY 3
+#define POLICY_MLFQ 4
+
+/* a waiting process gains one priority level every PRIORITY_AGING_TIME time units */
+#define PRIORITY_AGING_TIME 10
+
+/* MLFQ levels, each with twice the time allotment of the one above,
+    and how many quanta pass between boosts of every process back to the top level */
+#define MLFQ_LEVELS 3
+#define MLFQ_BOOST_QUANTA 64
+
+/* Returned when there are no more arrivals left to admit */
+#define NO_EVENT -1
+
+/* Most cores a simulation can have (-c), and the core of an untagged event line */
+#define MAX_CORES 256
+#define NO_CORE -1
+
+/* Clock of an idle core until something wakes it */
+#define PARKED LLONG_MAX
+
+/* Most configurations a parameter sweep will run */
+#define MAX_SWEEP_VALUES 64
+
+/* Streamed processes are pooled in chunks of this many slots,
+    and consumed input is handed back to the kernel this many bytes at a time */
+#define STREAM_CHUNK_PROCESSES 1024
+#define STREAM_RELEASE_SIZE (1 << 20)
+
+/* Latency histograms keep values below 2^HISTOGRAM_SUB_BITS exact and larger ones to within
+    one part in 2^(HISTOGRAM_SUB_BITS - 1), so any 64-bit value fits in a fixed number of buckets */
+#define HISTOGRAM_SUB_BITS 7
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS + 2) << (HISTOGRAM_SUB_BITS - 1))
+
+/* Per-process latencies recorded at completion, and the percentiles reported for each */
+#define LATENCY_TURNAROUND 0
+#define LATENCY_WAITING 1
+#define LATENCY_RESPONSE 2
+#define LATENCY_PREEMPTIONS 3
+#define LATENCY_METRICS 4
+#define LATENCY_PERCENTILES 4
+
+/* Size of the user-space buffer event logs are collected in before each write */
+#define LOG_BUFFER_SIZE (1 << 16)
+
+/* A run's arena grows by chunks of at least ARENA_CHUNK_SIZE bytes, handing out blocks aligned to
+    ARENA_ALIGNMENT; finished processes' frame lists are kept for reuse in one class per power of two */
+#define ARENA_CHUNK_SIZE (1 << 16)
+#define ARENA_ALIGNMENT 16
+#define FRAME_LIST_CLASSES 32
+
 /*******************************************************************************************************/
 /* Process Structure Definition 
+    only the state the scheduler reads and writes while a process is alive;
+    what is read once per process lives in the ProcessColumns under id.
+    lruPrev/lruNext link processes that hold frames in order of lastUsed, or under first-fit
+    the processes that hold a block, for compaction.
+    readyNext, level, levelEpoch and levelUsed are only used by the MLFQ scheduler.
+    firstRun and preemptions are kept for the latency metrics.
+    PmemoryAllocation is the page table of sizeOfFrames pages, of which residentFrames are in a frame
 */
-typedef struct {
-    int arrivalTime;
-    char processName[MAX_PROCESS_NAME_LEN];
-    int serviceTime;
-    int memoryRequirement;
-    int state;
-    int cpuTimeUsed;
-    int FFmemoryAllocation;
+typedef struct Process {
+    long long remainingTime;
+    long long memoryRequirement;
+    long long FFmemoryAllocation;
+    long long lastUsed;
+    long long levelUsed;
+    long long firstRun;
     int* PmemoryAllocation;
+    struct Process *lruPrev, *lruNext;
+    struct Process* readyNext;
+    int state;
     int sizeOfFrames;
-    int lastUsed;
-    int completionTime;
+    int residentFrames;
+    int id;
+    int level, levelEpoch;
+    int preemptions;
 } Process;
 
-/* Process Node
-    to store the processes in a linked list 
+/* Process Columns
+    struct-of-arrays of the per-process values that are written or read once,
+    so arrival admission and the statistics pass scan dense arrays instead of whole processes
 */
-typedef struct ProcessNode{
-    Process* process;
-    struct ProcessNode* next;
-} ProcessNode;
+typedef struct {
+    long long* arrivalTime;
+    long long* serviceTime;
+    long long* completionTime;
+    long long* priority;
+    char (*processName)[MAX_PROCESS_NAME_LEN];
+    int capacity;
+} ProcessColumns;
+
+/* Arena Chunk
+    one allocation of an arena, with its blocks following the header
+*/
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t size, used;
+} ArenaChunk;
+
+/* Arena
+    everything one run allocates: blocks are carved off the newest chunk in order and only released
+    all together by resetArena. frame lists of FINISHED processes are chained by size class in
+    frameLists, so a long run reuses them instead of growing
+*/
+typedef struct {
+    ArenaChunk* chunks;
+    int* frameLists[FRAME_LIST_CLASSES];
+} Arena;
 
+/* Process Queue
+    growable ring buffer of processes, so switching processes in and out of the CPU never allocates.
+    it holds pointers rather than table indices since streamed processes live in pooled chunks,
+    and its buffers come from the run's arena
+*/
 typedef struct ProcessQueue {
-    struct ProcessNode *head, *tail;
+    Process** slots;
+    int capacity;
+    int head, size;
+    Arena* arena;
 } ProcessQueue;
 
+/* Run Index Node
+    one process of an indexed run queue, as a node of a treap ordered by queue position.
+    need is the memory the process still has to be given, smallest the least need in its subtree
+    and count the size of its subtree
+*/
+typedef struct {
+    Process* process;
+    long long need, smallest;
+    int count;
+    unsigned int priority;
+    int left, right;
+} RunIndexNode;
+
+/* Run Index
+    rr run queue for memory given out by size, where a process that doesn't fit is passed over
+    to the back of the queue. nodes are pooled by index, with released nodes chained through their left link
+*/
+typedef struct {
+    RunIndexNode* nodes;
+    int nodeCount, nodeCapacity;
+    int freeNode;
+    int root;
+    unsigned int seed;
+    Arena* arena;
+} RunIndex;
+
+/* LRU List
+    resident processes from least (head) to most (tail) recently used
+*/
+typedef struct LRUList {
+    Process *head, *tail;
+} LRUList;
+
+/* Heap Entry
+    a process ordered by key, then by when it was pushed
+*/
+typedef struct {
+    long long key;
+    long long sequence;
+    Process* process;
+} HeapEntry;
+
+/* Process Heap
+    binary min-heap of processes on (key, sequence), grown in the arena
+*/
+typedef struct {
+    HeapEntry* entries;
+    int size, capacity;
+    long long sequence;
+    Arena* arena;
+} ProcessHeap;
+
+/* Ready List
+    FIFO of READY processes threaded through readyNext, so whole lists can be spliced in O(1)
+*/
+typedef struct {
+    Process *head, *tail;
+    int size;
+} ReadyList;
+
+/* Scheduler
+    the READY processes under one scheduling policy, and the process in the CPU.
+    rr keeps the ring buffer run queue, or the run index when memory is given out by size;
+    sjf, srtf and priority a binary heap of keys;
+    mlfq one ready list per level, where a process's level only counts if its levelEpoch
+    is the current epoch, so a boost is just a new epoch and a splice of the lists.
+    deferred holds processes that didn't fit in memory, for policies that would pick them straight back,
+    keyed by memory requirement so only those that could fit are released when memory is freed
+*/
+typedef struct {
+    int policy;
+    int quantum;
+    Process* running;
+    ProcessQueue* queue;
+    RunIndex* index;
+    ProcessHeap heap;
+    ReadyList levels[MLFQ_LEVELS];
+    int epoch;
+    long long nextBoost;
+    ProcessHeap deferred;
+    ProcessColumns* columns;
+    Arena* arena;
+} Scheduler;
+
+/* Free Extent
+    a maximal run of free memory, stored as a node of an address-ordered treap.
+    largest is the length of the longest free run anywhere in the node's subtree
+*/
+typedef struct {
+    long long start;
+    long long length;
+    long long largest;
+    unsigned int priority;
+    int left, right;
+} FreeExtent;
+
+/* Free Extent Tree
+    first-fit memory as an index of its free runs rather than one flag per KB.
+    nodes are pooled by index, with released nodes chained through their left link,
+    and holes counts the nodes in use, one per free run
+*/
+typedef struct {
+    FreeExtent* nodes;
+    int nodeCount, nodeCapacity;
+    int freeNode;
+    int holes;
+    int root;
+    long long capacity;
+    long long allocated;
+    unsigned int seed;
+    Arena* arena;
+} FreeExtentTree;
+
+/* Buddy Block
+    a free block of 2^order KB, linked into the free list of its order while free;
+    released blocks are chained through next
+*/
+typedef struct {
+    long long start;
+    int order;
+    int prev, next;
+} BuddyBlock;
+
+/* Buddy Allocator
+    buddy memory as one free list per block order. index is an open-addressed table of the free blocks
+    by start address, so the buddy of a freed block is found without a search.
+    memory that isn't a power of two is covered by the largest aligned blocks that fit, which never merge
+*/
+typedef struct {
+    BuddyBlock* blocks;
+    int blockCount, blockCapacity;
+    int freeBlock;
+    int heads[BUDDY_ORDERS];
+    int* index;
+    int indexCapacity;
+    int holes;
+    long long capacity;
+    long long allocated;
+    Arena* arena;
+} BuddyAllocator;
+
+/* Frame Table
+    paged memory as a bitmap with one bit per frame, set when the frame is allocated.
+    full has one bit per word of frames, set when that word has no free frame left,
+    and no group of 64 words before searchFrom has a free frame.
+    replacing single pages also keeps the owner of each frame and the page it holds, the frames
+    in load order from oldest for fifo, and the time clock's hand last cleared each frame for clock;
+    scratch holds the frames of one eviction or one sorted frame list.
+    workingSet is how many pages a process needs resident to run under virtual memory, 0 for all of them
+*/
+typedef struct {
+    uint64_t* frames;
+    uint64_t* full;
+    int frameCount;
+    int wordCount;
+    int allocated;
+    int pageSize;
+    int searchFrom;
+    Arena* arena;
+    int replacement;
+    struct Process** owner;
+    int* page;
+    int* scratch;
+    int *older, *newer;
+    int oldest, newest;
+    long long* cleared;
+    int hand;
+    int workingSet;
+} FrameTable;
+
+/* Log Writer
+    all simulation output is formatted into one buffer and handed to the kernel a buffer at a time.
+    events is cleared to only print the summary, frameRanges prints frame lists as runs (0-255)
+*/
+typedef struct {
+    int fd;
+    int events;
+    int frameRanges;
+    size_t length;
+    char buffer[LOG_BUFFER_SIZE];
+} LogWriter;
+
+/* Histogram
+    counts of recorded values in log-linear buckets, so recording is O(1) in fixed memory
+*/
+typedef struct {
+    long long counts[HISTOGRAM_BUCKETS];
+    long long total;
+    long long max;
+} Histogram;
+
+/* Future Plan
+    the times each process starts RUNNING, recorded by a run with infinite memory so opt can look ahead.
+    a process's starts are times[first[id]] up to times[first[id + 1]], and next[id] is the next one
+    still to come. while recording, the starts are appended to recordIds and recordTimes in time order
+*/
+typedef struct {
+    long long* times;
+    long long* first;
+    long long* next;
+    int processCount;
+    int recording;
+    int* recordIds;
+    long long* recordTimes;
+    long long recordCount, recordCapacity;
+} FuturePlan;
+
+/* Input Scanner
+    position in the mapped input file, with the current line for error messages.
+    every record is one line, so line is also the line the record being read started on
+*/
+typedef struct {
+    const char* cursor;
+    const char* end;
+    long long line;
+    const char* filename;
+} InputScanner;
+
+/* Simulation Configuration
+    everything read from the command line; a sweep runs one copy per (quantum, strategy) pair
+    and a batch one copy per input file. files lists every -f file, with directories expanded
+*/
+typedef struct {
+    char filename[MAX_PATH_LEN];
+    char memoryStrategy[MAX_FILENAME_STRATEGY_LEN];
+    int quantum;
+    long long memoryCapacity;
+    int pageSize;
+    char sweepQuanta[MAX_FILENAME_STRATEGY_LEN];
+    char sweepStrategies[MAX_FILENAME_STRATEGY_LEN];
+    int threads;
+    int bench;
+    int stream;
+    char policy[MAX_FILENAME_STRATEGY_LEN];
+    int cores;
+    int events;
+    int frameRanges;
+    char outputDir[MAX_PATH_LEN];
+    char (*files)[MAX_PATH_LEN];
+    int fileCount, fileCapacity;
+    int batch;
+    int latency;
+    char latencyCsv[MAX_PATH_LEN];
+    int memoryStats;
+    char replacement[MAX_FILENAME_STRATEGY_LEN];
+    double compactCost;
+} Config;
+
+/* Input File
+    which file an input path names, and its place in the input list, to find repeated inputs
+*/
+typedef struct {
+    dev_t device;
+    ino_t inode;
+    int index;
+} InputFile;
+
+/* Statistics Totals
+    running sums a summary is calculated from, added to one finished process at a time
+*/
+typedef struct {
+    long long count;
+    long long turnaround;
+    double overhead;
+    double maxOverhead;
+    long long makespan;
+} StatisticsTotals;
+
+/* Workload
+    where a simulation's processes come from: either the whole table sorted by arrival
+    and admitted through the admitted cursor, or, when streaming, records read from the
+    mapped input only as their arrival is reached. streamed processes live in pooled slots,
+    chained through lruNext while free, and are retired into totals once FINISHED;
+    next is the slot already holding the record that arrives next
+*/
+typedef struct {
+    Process* processes;
+    ProcessColumns columns;
+    int processCount;
+    int admitted;
+    int streaming;
+    InputScanner scanner;
+    const char* data;
+    size_t size, released;
+    Process* next;
+    Process** chunks;
+    int chunkCount, chunkCapacity;
+    Process* freeSlots;
+    StatisticsTotals totals;
+} Workload;
+
+/* Memory Metrics
+    fragmentation and memory pressure, updated as memory is allocated and freed rather than measured.
+    holes, largestHole and external describe first-fit's free runs or the buddy allocator's free blocks now,
+    with the worst seen so far; internal is the KB lost to rounding resident processes up to whole pages
+    or blocks, and pageFaults counts every page loaded into a frame. a process that didn't fit
+    while enough memory was free in total was blocked by fragmentation, unless compaction made room for it
+*/
+typedef struct {
+    int strategy;
+    int holes, maxHoles;
+    long long largestHole;
+    double external, maxExternal;
+    long long internal, maxInternal;
+    long long evictions, evictedFrames, pageFaults;
+    long long fragmentationBlocks, capacityBlocks;
+    int compaction;
+    long long compactions, compactedKB, compactionTime;
+} MemoryMetrics;
+
+/* Memory
+    the memory every core shares, under one strategy; only that strategy's structures are created.
+    first-fit compaction is on when compactCost, the time charged per KB moved, isn't negative,
+    and sorts the processes holding a block in blocks
+*/
+typedef struct {
+    int strategy;
+    FreeExtentTree* extents;
+    FrameTable* pages;
+    BuddyAllocator* buddy;
+    LRUList lru;
+    MemoryMetrics metrics;
+    double compactCost;
+    Process** blocks;
+    int blockCapacity;
+} Memory;
+
+/* Core
+    one simulated CPU with its own run queue. time is when it next makes a scheduling decision,
+    busy how long it has spent running processes, and idle is set while it has nothing it can run
+*/
+typedef struct {
+    int id;
+    Scheduler* scheduler;
+    long long time;
+    long long busy;
+    int idle;
+} Core;
+
+/* Simulation
+    the cores and memory of one run over a workload, all allocated from its arena.
+    plan is the future opt replacement looks ahead to, or the one this run records,
+    and events counts every RUNNING, FINISHED, EVICTED and COMPACTED event whether it is logged or not
+*/
+typedef struct {
+    Workload* workload;
+    Memory memory;
+    Core* cores;
+    int coreCount;
+    int quantum;
+    int remaining;
+    long long finished;
+    LogWriter* writer;
+    long long events;
+    Histogram* latency;
+    LogWriter* records;
+    int memoryStats;
+    Arena arena;
+    FuturePlan* plan;
+} Simulation;
+
+/* Simulation Statistics
+    the summary of one finished simulation, with each core's share of the makespan spent running
+    when there is more than one, and the latency percentiles and memory metrics when they were asked for.
+    events is how many RUNNING, FINISHED, EVICTED and COMPACTED events were simulated, logged or not, for --bench
+*/
+typedef struct {
+    long long turnaround;
+    double maxOverhead;
+    double avgOverhead;
+    long long makespan;
+    long long events;
+    StatisticsTotals totals;
+    int coreCount;
+    double utilisation[MAX_CORES];
+    int latency;
+    long long percentiles[LATENCY_METRICS][LATENCY_PERCENTILES];
+    int memoryStats;
+    MemoryMetrics memory;
+} Statistics;
+
+/* Batch
+    shared between batch workers, which take input files in order through next.
+    when the runs are tagged onto one stream, each run's log goes to a closed temporary file named in logs
+    until every earlier run is done; done marks the finished runs, copied is the next one to copy out
+    and copying is set while a worker copies
+*/
+typedef struct {
+    Config* config;
+    Statistics* results;
+    LogWriter* writer;
+    char (*logs)[MAX_PATH_LEN];
+    int* done;
+    int next, copied, copying;
+    pthread_mutex_t lock;
+} Batch;
+
+/* Parameter Sweep
+    shared between sweep workers, which take configurations in order through next.
+    inOrder is cleared when the workload is out of arrival order and each worker has to sort its own copy
+*/
+typedef struct {
+    Workload* workload;
+    int inOrder;
+    Config* configs;
+    Statistics* results;
+    int configCount;
+    int next;
+    pthread_mutex_t lock;
+} Sweep;
+
 /*******************************************************************************************************/
 // List of Functions
 
 /* Standard Queue Functions */
-ProcessNode* newProcessNode(Process* process);
-ProcessQueue* createQueue();
+ProcessQueue* createQueue(Arena* arena);
 void enqueue(ProcessQueue* processQueue, Process* process);
 Process* dequeue(ProcessQueue* processQueue);
+Process* front(ProcessQueue* processQueue);
+
+/* Run Index Functions */
+RunIndex* createRunIndex(Arena* arena);
+int newRunIndexNode(RunIndex* index, Process* process, long long need);
+void updateRunIndexNode(RunIndex* index, int node);
+int mergeRunIndex(RunIndex* index, int left, int right);
+void splitRunIndex(RunIndex* index, int node, int count, int* left, int* right);
+void appendRunIndex(RunIndex* index, Process* process, long long need);
+Process* takeRunIndex(RunIndex* index, long long limit);
+Process* firstRunIndex(RunIndex* index);
+int runIndexSize(RunIndex* index);
+
+/* Scheduler Functions */
+Scheduler* createScheduler(Arena* arena, char policy[], int quantum, ProcessColumns* columns, int sizedMemory);
+void makeReady(Scheduler* scheduler, Process* process, long long time);
+Process* runningProcess(Scheduler* scheduler);
+Process* takeRunning(Scheduler* scheduler);
+Process* pickNext(Scheduler* scheduler);
+int readyProcesses(Scheduler* scheduler);
+int scheduledProcesses(Scheduler* scheduler);
+int shouldPreempt(Scheduler* scheduler, Process* process, long long time);
+long long runLimit(Scheduler* scheduler, Process* process, long long time);
+void chargeRun(Scheduler* scheduler, Process* process, long long slice);
+void deferProcess(Scheduler* scheduler, Process* process, long long time);
+int releaseDeferred(Scheduler* scheduler, long long time, long long largest, long long* room);
+void pushHeap(ProcessHeap* heap, long long key, Process* process);
+Process* popHeap(ProcessHeap* heap);
+int currentLevel(Scheduler* scheduler, Process* process);
+long long levelAllotment(Scheduler* scheduler, int level);
+void boostLevels(Scheduler* scheduler, long long time);
 
 /* Pre-Task Process Functions */
-void readInput(int argc, char* argv[], char filename[], char memoryStrategy[], int* quantum);
-Process* readProcesses(char filename[], int* processCount);
+void readInput(int argc, char* argv[], Config* config);
+void addInputPath(Config* config, const char* path);
+int compareFiles(const void* a, const void* b);
+void removeDuplicateInputs(Config* config);
+int compareInputFiles(const void* a, const void* b);
+void checkOutputPaths(Config* config);
+Workload* loadWorkload(Config* config);
+Workload* readProcesses(char filename[]);
+int skipWhitespace(InputScanner* scanner);
+int skipBlanks(InputScanner* scanner);
+void inputError(InputScanner* scanner, const char* message, const char* field);
+long long scanInteger(InputScanner* scanner, const char* field);
+long long scanOptionalInteger(InputScanner* scanner, const char* field);
+void scanName(InputScanner* scanner, char name[]);
+void scanProcess(InputScanner* scanner, ProcessColumns* columns, Process* process);
+int inAdmissionOrder(Workload* workload, int quantum);
+void sortByArrival(Workload* workload, int quantum);
+long long admissionBoundary(long long arrivalTime, int quantum);
+
+/* Workload Functions */
+Workload* mapWorkload(char filename[]);
+Workload* openStream(char filename[]);
+void closeWorkload(Workload* workload);
+void growColumns(ProcessColumns* columns, int capacity);
+void freeColumns(ProcessColumns* columns);
+void readNextRecord(Workload* workload);
+Process* takeSlot(Workload* workload);
+int pendingArrivals(Workload* workload);
+void retireProcess(Workload* workload, Process* process, long long time);
 
 /* Process Manager Functions */
-void allocate(Process* processes, int processCount, int quantum, char memoryStrategy[]);
-void checkProcesses(ProcessQueue* processQ, Process* processes, int processCount, 
-                    int time, int* remaining, int quantum);
-int update(Process* CPUproc, int quantum, int* time, int* finished, int remaining, int* isNew);
-void calculateStatistics(Process* processes, int processCount);
-
-int calculateMemUsage(int* memory);
-int calculatePageMemUsage(int* pages);
-int* createMemory(char memoryStrategy[]);
-int allocateMemoryBlock(int* memory, int memoryRequirement);
-int* allocatePages(int* memory, int memoryRequirement, int* frameSize);
-void deallocateMemoryBlock(int* memory, int allocationStart, int allocationSize);
-void deallocatePages(int* memory, int* frameSize, int* frames);
-void evictLRU(int processCount, Process* processes, int* memory, int time);
-
-/* Task Algorithms */
-void firstFitRR(ProcessQueue* processQ, int* memory, Process* processes, int processCount, int quantum);
-void infiniteRR(ProcessQueue* processQ, Process* processes, int processCount, int quantum);
-void pagedMemoryRR(ProcessQueue* processQ, int* pages, Process* processes, int processCount, int quantum);
+Statistics allocate(Workload* workload, Config* config, LogWriter* writer, FuturePlan* record);
+void checkProcesses(Simulation* simulation, long long time);
+void admitProcess(Simulation* simulation, Process* process, long long time);
+long long nextArrivalBoundary(Workload* workload, int quantum);
+int update(Process* CPUproc, int quantum, long long* time, long long* finished, Scheduler* scheduler, int* isNew,
+           long long horizon);
+Statistics calculateStatistics(ProcessColumns* columns, int processCount);
+void addStatistics(StatisticsTotals* totals, long long arrival, long long service, long long completion);
+Statistics finishStatistics(StatisticsTotals* totals);
+void printStatistics(LogWriter* writer, Statistics* statistics);
+void printBench(struct timespec* start, long long events);
+
+/* Latency Functions */
+void recordLatency(Simulation* simulation, Process* process, long long time);
+void recordValue(Histogram* histogram, long long value);
+int histogramIndex(long long value);
+long long histogramPercentile(Histogram* histogram, int permille);
+
+/* Parameter Sweep Functions */
+long long sweep(Workload* workload, Config* config, LogWriter* writer);
+void* sweepWorker(void* arg);
+void runWorkers(int requested, int jobs, void* (*worker)(void*), void* arg);
+
+/* Batch Functions */
+long long batch(Config* config, LogWriter* writer);
+void* batchWorker(void* arg);
+void outputPath(char path[], const char* directory, const char* input);
+int temporaryLog(char path[]);
+void copyFinished(Batch* run);
+void copyTagged(LogWriter* writer, const char* path, const char* tag);
+void logBatchRow(LogWriter* writer, const char* name, Statistics* statistics);
+
+int calculateMemUsage(FreeExtentTree* memory);
+int calculatePageMemUsage(FrameTable* pages);
+int calculateBuddyMemUsage(BuddyAllocator* buddy);
+FrameTable* createFrameTable(Arena* arena, int frameCount, int pageSize);
+void enablePageReplacement(FrameTable* pages, int replacement);
+int replacementPolicy(const char* name);
+int pagesFor(FrameTable* pages, long long memoryRequirement);
+void takeFrames(FrameTable* pages, int count, int* frames);
+void freeFrame(FrameTable* pages, int frame);
+void releaseFrame(FrameTable* pages, int frame);
+
+/* Future Plan Functions */
+FuturePlan* planFutureUse(Arena* arena, Workload* workload, Config* config);
+void recordStart(FuturePlan* plan, int id, long long time);
+long long nextUse(FuturePlan* plan, Process* process);
+long long allocateMemoryBlock(FreeExtentTree* memory, long long memoryRequirement);
+int* allocatePages(FrameTable* pages, long long memoryRequirement, int* frames, int* frameSize);
+void deallocateMemoryBlock(FreeExtentTree* memory, long long allocationStart, long long allocationSize);
+void deallocatePages(FrameTable* pages, int* frameSize, int* frames);
+int evictLRU(Memory* memory, long long time, LogWriter* writer, int core);
+void compactMemory(Simulation* simulation, Core* core);
+Process** sortBlocks(Process** blocks, Process** sorted, int count, long long capacity);
+void touchLRU(LRUList* lru, Process* process, long long time);
+void removeLRU(LRUList* lru, Process* process);
+void measureExtents(Memory* memory);
+int acquirePages(Simulation* simulation, Core* core, Process* process, int minimum);
+void loadPages(Memory* memory, Process* process, int count, long long time);
+void evictPages(Simulation* simulation, Core* core, Process* requester, int count);
+void evictFrame(Memory* memory, int frame);
+void unloadPages(Memory* memory, Process* process);
+Process* victimProcess(Simulation* simulation, Process* requester);
+int victimFrame(Memory* memory, Process* requester, long long time);
+int* sortedFrames(Process* process, int* frames);
+int compareFrames(const void* a, const void* b);
+void measureRounding(Memory* memory, Process* process, int resident);
+void blockedProcess(Memory* memory, Process* process);
+
+/* Free Extent Tree Functions */
+FreeExtentTree* createFreeExtentTree(Arena* arena, long long capacity);
+int newFreeExtent(FreeExtentTree* tree, long long start, long long length);
+void releaseFreeExtent(FreeExtentTree* tree, int node);
+void updateFreeExtent(FreeExtentTree* tree, int node);
+int mergeFreeExtents(FreeExtentTree* tree, int left, int right);
+void splitFreeExtents(FreeExtentTree* tree, int node, long long start, int* left, int* right);
+int takeFirstFit(FreeExtentTree* tree, int node, long long length, long long* start);
+int popFreeExtent(FreeExtentTree* tree, int node, int fromRight, int* popped);
+void compactFreeExtents(FreeExtentTree* tree);
+
+/* Buddy Allocator Functions */
+BuddyAllocator* createBuddyAllocator(Arena* arena, long long capacity);
+long long allocateBuddyBlock(BuddyAllocator* buddy, long long memoryRequirement);
+void deallocateBuddyBlock(BuddyAllocator* buddy, long long start, long long memoryRequirement);
+int buddyOrder(long long memoryRequirement);
+long long largestBuddyBlock(BuddyAllocator* buddy);
+void addBuddyBlock(BuddyAllocator* buddy, long long start, int order);
+void removeBuddyBlock(BuddyAllocator* buddy, int block);
+int findBuddyBlock(BuddyAllocator* buddy, long long start);
+int buddyHash(BuddyAllocator* buddy, long long start);
+int buddySlot(BuddyAllocator* buddy, long long start);
+void growBuddyIndex(BuddyAllocator* buddy);
+
+/* Arena Functions */
+void* arenaAlloc(Arena* arena, size_t size);
+void* arenaGrow(Arena* arena, void* block, size_t size, size_t newSize);
+int* takeFrameList(Arena* arena, int frameCount);
+void giveFrameList(Arena* arena, int* frames, int frameCount);
+int frameListClass(int frameCount);
+void resetArena(Arena* arena);
+
+/* Output Functions */
+void flushLog(LogWriter* writer);
+void logString(LogWriter* writer, const char* string);
+void logBytes(LogWriter* writer, const char* bytes, size_t length);
+void logInt(LogWriter* writer, long long value);
+void logFrames(LogWriter* writer, int* frames, int frameCount);
+void logRunning(LogWriter* writer, long long time, const char* processName, long long remainingTime);
+void logEvicted(LogWriter* writer, long long time, int* frames, int frameCount, int core);
+void logCompacted(LogWriter* writer, long long time, long long moved, long long cost, int core);
+void logFinished(LogWriter* writer, long long time, const char* processName, int remaining, int core);
+void logEventEnd(LogWriter* writer, int core);
+void logMemoryMetrics(LogWriter* writer, MemoryMetrics* metrics);
+
+/* Scheduling Loop */
+void simulate(Simulation* simulation);
+Core* nextCore(Simulation* simulation);
+void runCore(Simulation* simulation, Core* core, long long horizon);
+Process* dispatch(Simulation* simulation, Core* core);
+int acquireMemory(Simulation* simulation, Core* core, Process* process);
+void startRunning(Simulation* simulation, Core* core, Process* process);
+void finishProcess(Simulation* simulation, Core* core, Process* process);
+void switchOut(Simulation* simulation, Core* core, Process* process);
+int runningFrames(Simulation* simulation);
+void releaseMemory(Simulation* simulation, long long time);
+long long largestRequest(Memory* memory);
+long long freeMemory(Memory* memory);
+long long sliceHorizon(Simulation* simulation, Core* core, long long horizon);
+Core* stealVictim(Simulation* simulation, Core* thief);
+void stealProcess(Simulation* simulation, Core* thief);
+void wakeCore(Core* core, long long time);
+int coreTag(Simulation* simulation, Core* core);
 
 /*******************************************************************************************************/
 int main(int argc, char* argv[]) {
-    char filename[MAX_FILENAME_STRATEGY_LEN], memoryStrategy[MAX_FILENAME_STRATEGY_LEN];
-    int quantum;
+    Config config = {"", "", 0, DEFAULT_MEMORY_CAPACITY, DEFAULT_PAGE_SIZE, "", "", 0, FALSE, FALSE, ROUND_ROBIN, 1, 
+                     TRUE, FALSE, "", NULL, 0, 0, FALSE, FALSE, "", FALSE, "", NO_COMPACTION};
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
     
     /* read command line arguments for simulation specifications */
-    readInput(argc, argv, filename, memoryStrategy, &quantum);
+    readInput(argc, argv, &config);
 
-    /* read and store processes to be simulated */
-    int processCount;
-    Process* processes = readProcesses(filename, &processCount);
+    /* buffered standard output shared by every log line */
+    LogWriter writer = {STDOUT_FILENO, config.events, config.frameRanges, 0};
+    long long events;
+
+    /* many input files are simulated as independent runs of a batch */
+    if (config.batch) {
+        events = batch(&config, &writer);
+    } else {
+        Workload* workload = loadWorkload(&config);
 
-    /* allocate the processes for the CPU */
-    allocate(processes, processCount, quantum, memoryStrategy);
+        /* either sweep over many configurations of the same workload,
+            or allocate the processes for the CPU once and log every event */
+        if (config.sweepQuanta[0] != '\0' || config.sweepStrategies[0] != '\0') {
+            events = sweep(workload, &config, &writer);
+        } else {
+            Statistics statistics = allocate(workload, &config, &writer, NULL);
+            printStatistics(&writer, &statistics);
+            events = statistics.events;
+        }
+        closeWorkload(workload);
+    }
+    flushLog(&writer);
+    free(config.files);
 
+    if (config.bench) {
+        printBench(&start, events);
+    }
     return 0;
 }
 
-/* process manager: allocate processes into the CPU until all completed;
-    Acts as a queue, where only process at the head is considered RUNNING in the CPU
-    and all following processes are READY
+/* a streamed workload is read as the simulation reaches each arrival,
+    so only processes that are alive at once are ever held in memory.
+    otherwise read and store every process, ordered by arrival so they can be admitted in a single pass;
+    a sweep orders its copies for each quantum instead
+*/
+Workload* loadWorkload(Config* config) {
+    if (config->stream) {
+        return openStream(config->filename);
+    }
+    Workload* workload = readProcesses(config->filename);
+    if (config->sweepQuanta[0] == '\0' && config->sweepStrategies[0] == '\0') {
+        sortByArrival(workload, config->quantum);
+    }
+    return workload;
+}
+
+/* process manager: allocate processes into the cores until all completed;
+    each core acts as a run queue, where only the process it picked is considered RUNNING
+    and all others are READY. a run given record only records when each process runs, for opt
+*/
+Statistics allocate(Workload* workload, Config* config, LogWriter* writer, FuturePlan* record) {
+    Simulation simulation = {workload, {MEMORY_UNSUPPORTED, NULL, NULL, NULL, {NULL, NULL}}, NULL, config->cores,
+                             config->quantum, 0, 0, writer, 0, NULL, NULL, config->memoryStats, {NULL, {NULL}}, record};
+    Memory* memory = &simulation.memory;
+
+    /* Task 1: Infinite Memory, Task 2: First-Fit, Task 3: Paged, Task 4: Virtual, and the Buddy allocator.
+        bench.sh benchmarks every one of them by default, so a new strategy is added to its STRATEGIES too */
+    if (strcmp(INFINITE_MEMORY, config->memoryStrategy) == 0) {
+        memory->strategy = MEMORY_INFINITE;
+    } else if (strcmp(config->memoryStrategy, FIRST_FIT) == 0) {
+        memory->strategy = MEMORY_FIRST_FIT;
+        memory->extents = createFreeExtentTree(&simulation.arena, config->memoryCapacity);
+        memory->compactCost = config->compactCost;
+        memory->metrics.compaction = (config->compactCost != NO_COMPACTION);
+        measureExtents(memory);
+    } else if (strcmp(config->memoryStrategy, PAGED) == 0) {
+        memory->strategy = MEMORY_PAGED;
+        memory->pages = createFrameTable(&simulation.arena, (int)(config->memoryCapacity / config->pageSize), 
+                                         config->pageSize);
+        enablePageReplacement(memory->pages, replacementPolicy(config->replacement));
+    } else if (strcmp(config->memoryStrategy, VIRTUAL) == 0) {
+        /* paged memory where a process runs with only its working set resident, evicting pages by lru by default */
+        memory->strategy = MEMORY_PAGED;
+        memory->pages = createFrameTable(&simulation.arena, (int)(config->memoryCapacity / config->pageSize), 
+                                         config->pageSize);
+        int replacement = replacementPolicy(config->replacement);
+        enablePageReplacement(memory->pages, (replacement == REPLACEMENT_PROCESS) ? REPLACEMENT_LRU : replacement);
+        memory->pages->workingSet = VIRTUAL_WORKING_SET;
+    } else if (strcmp(config->memoryStrategy, BUDDY) == 0) {
+        memory->strategy = MEMORY_BUDDY;
+        memory->buddy = createBuddyAllocator(&simulation.arena, config->memoryCapacity);
+        measureExtents(memory);
+    } else {
+        fprintf(stderr, "Unknown memory strategy: %s\n", config->memoryStrategy);
+        exit(EXIT_FAILURE);
+    }
+    memory->metrics.strategy = memory->strategy;
+
+    /* opt needs to know when each process will next run before the run starts */
+    if (memory->strategy == MEMORY_PAGED && memory->pages->replacement == REPLACEMENT_OPT && record == NULL) {
+        simulation.plan = planFutureUse(&simulation.arena, workload, config);
+    }
+
+    simulation.cores = (Core*)arenaAlloc(&simulation.arena, sizeof(Core) * simulation.coreCount);
+    for (int i = 0; i < simulation.coreCount; i++) {
+        simulation.cores[i].id = i;
+        simulation.cores[i].scheduler = createScheduler(&simulation.arena, config->policy, config->quantum, 
+                                                        &workload->columns, memory->strategy == MEMORY_FIRST_FIT ||
+                                                        memory->strategy == MEMORY_BUDDY);
+        simulation.cores[i].idle = TRUE;
+        simulation.cores[i].time = PARKED;
+    }
+
+    /* latencies are recorded as each process finishes, so the table is never scanned again for them */
+    LogWriter* records = NULL;
+    if (config->latency) {
+        simulation.latency = (Histogram*)arenaAlloc(&simulation.arena, sizeof(Histogram) * LATENCY_METRICS);
+    }
+    if (config->latencyCsv[0] != '\0') {
+        records = (LogWriter*)arenaAlloc(&simulation.arena, sizeof(LogWriter));
+        records->fd = open(config->latencyCsv, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (records->fd < 0) {
+            perror(config->latencyCsv);
+            exit(EXIT_FAILURE);
+        }
+        records->events = TRUE;
+        records->frameRanges = FALSE;
+        records->length = 0;
+        logString(records, "process-name,arrival-time,service-time,completion-time,turnaround,waiting,response,"
+                           "preemptions\n");
+        simulation.records = records;
+    }
+
+    if (memory->strategy != MEMORY_UNSUPPORTED) {
+        simulate(&simulation);
+    }
+
+    /* streamed processes were added to the totals as they were retired */
+    Statistics statistics = workload->streaming ? finishStatistics(&workload->totals)
+                                                : calculateStatistics(&workload->columns, workload->processCount);
+    statistics.events = simulation.events;
+    statistics.coreCount = simulation.coreCount;
+    statistics.memoryStats = config->memoryStats;
+    statistics.memory = memory->metrics;
+    for (int i = 0; i < simulation.coreCount; i++) {
+        statistics.utilisation[i] = (statistics.makespan > 0) 
+                                    ? (double)simulation.cores[i].busy / statistics.makespan * 100 : 0;
+    }
+
+    if (simulation.latency != NULL) {
+        int permille[LATENCY_PERCENTILES] = {500, 900, 990, 999};
+        statistics.latency = TRUE;
+        for (int metric = 0; metric < LATENCY_METRICS; metric++) {
+            for (int i = 0; i < LATENCY_PERCENTILES; i++) {
+                statistics.percentiles[metric][i] = histogramPercentile(&simulation.latency[metric], permille[i]);
+            }
+        }
+    }
+    if (records != NULL) {
+        flushLog(records);
+        close(records->fd);
+    }
+
+    /* cores, run queues, memory and frame lists all go at once */
+    resetArena(&simulation.arena);
+    return statistics;
+}
+  
+
+Statistics calculateStatistics(ProcessColumns* columns, int processCount){
+    long long* arrival = columns->arrivalTime;
+    long long* service = columns->serviceTime;
+    long long* completion = columns->completionTime;
+    StatisticsTotals totals = {processCount, 0, 0, 0, 0};
+
+    /* Turnaround Time and Makespan are plain integer reductions over two dense columns */
+    for(int i = 0; i<processCount; i++){
+        totals.turnaround += completion[i] - arrival[i];
+        if(totals.makespan < completion[i]){
+            totals.makespan = completion[i];
+        }
+    }
+
+    /* Time Overhead is summed in table order, so the rounded averages never depend on the build */
+    for(int i = 0; i<processCount; i++){
+        double time_overhead = (double)(completion[i] - arrival[i])/service[i];
+        totals.overhead += time_overhead;
+        if(totals.maxOverhead<time_overhead){
+            totals.maxOverhead = time_overhead;
+        }
+    }
+    return finishStatistics(&totals);
+}
+
+/* add one FINISHED process's turnaround, overhead and completion to the totals
+*/
+void addStatistics(StatisticsTotals* totals, long long arrival, long long service, long long completion) {
+    // Turnaround Time
+    totals->turnaround += completion - arrival;
+
+    // Time Overhead
+    double time_overhead = (double)(completion - arrival)/service;
+    totals->overhead += time_overhead;
+    if(totals->maxOverhead<time_overhead){
+        totals->maxOverhead = time_overhead;
+    }
+
+    //Makespan
+    if(totals->makespan < completion){
+        totals->makespan = completion;
+    }
+    totals->count++;
+}
+
+Statistics finishStatistics(StatisticsTotals* totals) {
+    double max_time_overhead = round(totals->maxOverhead*100)/100;
+    long long avg_time_turnaround = ceil((double)totals->turnaround/totals->count);
+    double avg_time_overhead = round(totals->overhead/totals->count*100)/100;
+
+    Statistics statistics = {avg_time_turnaround, max_time_overhead, avg_time_overhead, totals->makespan, 0};
+    statistics.totals = *totals;
+    return statistics;
+}
+
+void printStatistics(LogWriter* writer, Statistics* statistics) {
+    char overhead[64];
+    snprintf(overhead, sizeof(overhead), "%.2f %.2f\n", statistics->maxOverhead, statistics->avgOverhead);
+
+    logString(writer, "Turnaround time ");
+    logInt(writer, statistics->turnaround);
+    logString(writer, "\nTime overhead ");
+    logString(writer, overhead);
+    logString(writer, "Makespan ");
+    logInt(writer, statistics->makespan);
+
+    /* share of the makespan each core spent running a process */
+    if (statistics->coreCount > 1) {
+        logString(writer, "\nCore utilisation");
+        for (int i = 0; i < statistics->coreCount; i++) {
+            char utilisation[64];
+            snprintf(utilisation, sizeof(utilisation), " %d=%.2f%%", i, statistics->utilisation[i]);
+            logString(writer, utilisation);
+        }
+    }
+
+    /* tail latencies, one line per metric */
+    if (statistics->latency) {
+        const char* metrics[LATENCY_METRICS] = {"\nTurnaround", "\nWaiting", "\nResponse", "\nPreemptions"};
+        const char* percentiles[LATENCY_PERCENTILES] = {" p50=", " p90=", " p99=", " p99.9="};
+        for (int metric = 0; metric < LATENCY_METRICS; metric++) {
+            logString(writer, metrics[metric]);
+            for (int i = 0; i < LATENCY_PERCENTILES; i++) {
+                logString(writer, percentiles[i]);
+                logInt(writer, statistics->percentiles[metric][i]);
+            }
+        }
+    }
+
+    /* the worst fragmentation of the run and why processes had to wait for memory */
+    MemoryMetrics* memory = &statistics->memory;
+    if (!statistics->memoryStats || memory->strategy == MEMORY_INFINITE || memory->strategy == MEMORY_UNSUPPORTED) {
+        return;
+    }
+    logString(writer, "\nMemory");
+    if (memory->strategy != MEMORY_PAGED) {
+        char external[64];
+        snprintf(external, sizeof(external), "%.2f", memory->maxExternal);
+        logString(writer, " max-holes=");
+        logInt(writer, memory->maxHoles);
+        logString(writer, " max-external-fragmentation=");
+        logString(writer, external);
+    }
+    if (memory->strategy != MEMORY_FIRST_FIT) {
+        logString(writer, " max-internal-fragmentation=");
+        logInt(writer, memory->maxInternal);
+    }
+    if (memory->strategy == MEMORY_PAGED) {
+        logString(writer, " evictions=");
+        logInt(writer, memory->evictions);
+        logString(writer, " evicted-frames=");
+        logInt(writer, memory->evictedFrames);
+        logString(writer, " page-faults=");
+        logInt(writer, memory->pageFaults);
+    } else {
+        logString(writer, " fragmentation-blocked=");
+        logInt(writer, memory->fragmentationBlocks);
+    }
+
+    logString(writer, " capacity-blocked=");
+    logInt(writer, memory->capacityBlocks);
+    if (memory->compaction) {
+        logString(writer, " compactions=");
+        logInt(writer, memory->compactions);
+        logString(writer, " compacted-kb=");
+        logInt(writer, memory->compactedKB);
+        logString(writer, " compaction-time=");
+        logInt(writer, memory->compactionTime);
+    }
+}
+
+/* benchmark line on stderr, kept off stdout so the simulation output is unchanged;
+    ru_maxrss is in KB on Linux
+*/
+void printBench(struct timespec* start, long long events) {
+    struct timespec end;
+    struct rusage usage;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    getrusage(RUSAGE_SELF, &usage);
+
+    double seconds = (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+    fprintf(stderr, "events=%lld,wall-seconds=%.3f,events-per-second=%.0f,peak-rss-kb=%ld\n",
+            events, seconds, (seconds > 0) ? events / seconds : 0.0,
+            usage.ru_maxrss);
+}
+
+/*******************************************************************************************************/
+/* Latency Metrics
+
+    Each FINISHED process adds its turnaround, waiting time (turnaround less the time it held a core),
+    response time (first RUNNING less arrival) and number of preemptions to one histogram per metric,
+    and is written as a CSV record when requested
+*/
+void recordLatency(Simulation* simulation, Process* process, long long time) {
+    ProcessColumns* columns = &simulation->workload->columns;
+    long long arrival = columns->arrivalTime[process->id];
+    long long service = columns->serviceTime[process->id];
+    long long turnaround = time - arrival;
+
+    /* a process holds the core for whole quanta, so its remaining time ends at or below zero */
+    long long waiting = turnaround - (service - process->remainingTime);
+    long long response = process->firstRun - arrival;
+
+    if (simulation->latency != NULL) {
+        recordValue(&simulation->latency[LATENCY_TURNAROUND], turnaround);
+        recordValue(&simulation->latency[LATENCY_WAITING], waiting);
+        recordValue(&simulation->latency[LATENCY_RESPONSE], response);
+        recordValue(&simulation->latency[LATENCY_PREEMPTIONS], process->preemptions);
+    }
+    if (simulation->records != NULL) {
+        LogWriter* records = simulation->records;
+        logString(records, columns->processName[process->id]);
+        long long fields[] = {arrival, service, time, turnaround, waiting, response, process->preemptions};
+        for (int i = 0; i < (int)(sizeof(fields) / sizeof(fields[0])); i++) {
+            logString(records, ",");
+            logInt(records, fields[i]);
+        }
+        logString(records, "\n");
+    }
+}
+
+void recordValue(Histogram* histogram, long long value) {
+    if (value < 0) {
+        value = 0;
+    }
+    histogram->counts[histogramIndex(value)]++;
+    histogram->total++;
+    if (histogram->max < value) {
+        histogram->max = value;
+    }
+}
+
+/* values below 2^HISTOGRAM_SUB_BITS have a bucket each. above that, every power of two is split
+    into 2^(HISTOGRAM_SUB_BITS - 1) buckets by the bits just below the leading one
+*/
+int histogramIndex(long long value) {
+    if (value < (1LL << HISTOGRAM_SUB_BITS)) {
+        return (int)value;
+    }
+    int shift = (63 - __builtin_clzll((unsigned long long)value)) - (HISTOGRAM_SUB_BITS - 1);
+    return (shift << (HISTOGRAM_SUB_BITS - 1)) + (int)(value >> shift);
+}
+
+/* the smallest value at or below which permille thousandths of the recorded values lie,
+    as the highest value of its bucket but never more than the largest value recorded
+*/
+long long histogramPercentile(Histogram* histogram, int permille) {
+    if (histogram->total == 0) {
+        return 0;
+    }
+    long long rank = (histogram->total * permille + 999) / 1000;
+    long long seen = 0;
+    int index = 0;
+    while (index < HISTOGRAM_BUCKETS - 1) {
+        seen += histogram->counts[index];
+        if (seen >= rank) {
+            break;
+        }
+        index++;
+    }
+
+    long long highest = index;
+    if (index >= (1 << HISTOGRAM_SUB_BITS)) {
+        int shift = (index >> (HISTOGRAM_SUB_BITS - 1)) - 1;
+        long long sub = index - ((long long)shift << (HISTOGRAM_SUB_BITS - 1));
+        highest = ((sub + 1) << shift) - 1;
+    }
+    return (highest < histogram->max) ? highest : histogram->max;
+}
+
+/*******************************************************************************************************/
+/* Parameter Sweep
+
+    Runs every (quantum, strategy) pair from the sweep lists on a pool of threads.
+    The workload is parsed once; each configuration simulates its own copy of the process state
+    and completion times over the shared read-only columns,
+    and event logging is switched off so the workers share nothing but the sweep cursor
+*/
+long long sweep(Workload* workload, Config* config, LogWriter* writer) {
+    int quanta[MAX_SWEEP_VALUES], quantumCount = 0, strategyCount = 0;
+    char strategies[MAX_SWEEP_VALUES][MAX_FILENAME_STRATEGY_LEN];
+    char list[MAX_FILENAME_STRATEGY_LEN], *saved, *value;
+
+    /* a missing list sweeps over the single -q or -m value */
+    snprintf(list, sizeof(list), "%s", config->sweepQuanta);
+    for (value = strtok_r(list, ",", &saved); value != NULL && quantumCount < MAX_SWEEP_VALUES;
+         value = strtok_r(NULL, ",", &saved)) {
+        quanta[quantumCount++] = atoi(value);
+    }
+    if (quantumCount == 0) {
+        quanta[quantumCount++] = config->quantum;
+    }
+    snprintf(list, sizeof(list), "%s", config->sweepStrategies);
+    for (value = strtok_r(list, ",", &saved); value != NULL && strategyCount < MAX_SWEEP_VALUES;
+         value = strtok_r(NULL, ",", &saved)) {
+        snprintf(strategies[strategyCount++], MAX_FILENAME_STRATEGY_LEN, "%s", value);
+    }
+    if (strategyCount == 0) {
+        snprintf(strategies[strategyCount++], MAX_FILENAME_STRATEGY_LEN, "%s", config->memoryStrategy);
+    }
+
+    Sweep run;
+    run.workload = workload;
+    run.inOrder = inAdmissionOrder(workload, 1);
+    run.configCount = quantumCount * strategyCount;
+    run.next = 0;
+    run.configs = (Config*)malloc(sizeof(Config) * run.configCount);
+    run.results = (Statistics*)malloc(sizeof(Statistics) * run.configCount);
+    if (run.configs == NULL || run.results == NULL) {
+        fprintf(stderr, "Malloc failure: Sweep Not Initialized\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < run.configCount; i++) {
+        run.configs[i] = *config;
+        run.configs[i].quantum = quanta[i / strategyCount];
+        snprintf(run.configs[i].memoryStrategy, MAX_FILENAME_STRATEGY_LEN, "%s", strategies[i % strategyCount]);
+    }
+    pthread_mutex_init(&run.lock, NULL);
+    runWorkers(config->threads, run.configCount, sweepWorker, &run);
+
+    /* one row per configuration, in sweep order */
+    long long events = 0;
+    logString(writer, "quantum,memory-strategy,turnaround,max-overhead,avg-overhead,makespan\n");
+    for (int i = 0; i < run.configCount; i++) {
+        events += run.results[i].events;
+        char overhead[64];
+        snprintf(overhead, sizeof(overhead), ",%.2f,%.2f,", run.results[i].maxOverhead, run.results[i].avgOverhead);
+        logInt(writer, run.configs[i].quantum);
+        logString(writer, ",");
+        logString(writer, run.configs[i].memoryStrategy);
+        logString(writer, ",");
+        logInt(writer, run.results[i].turnaround);
+        logString(writer, overhead);
+        logInt(writer, run.results[i].makespan);
+        logString(writer, "\n");
+    }
+
+    pthread_mutex_destroy(&run.lock);
+    free(run.configs);
+    free(run.results);
+    return events;
+}
+
+/* take configurations off the sweep until none are left,
+    simulating each against a private copy of the process state
+*/
+void* sweepWorker(void* arg) {
+    Sweep* run = (Sweep*)arg;
+    LogWriter quiet = {STDOUT_FILENO, FALSE, FALSE, 0};
+    Workload workload = *run->workload;
+    int processCount = workload.processCount;
+    workload.processes = (Process*)malloc(sizeof(Process) * processCount);
+    if (workload.processes == NULL) {
+        fprintf(stderr, "Malloc failure: Process Array Not Copied\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* a workload out of arrival order is admitted in a different order under each quantum,
+        so the worker sorts a private copy of every column rather than sharing them */
+    if (run->inOrder) {
+        workload.columns.completionTime = (long long*)malloc(sizeof(long long) * processCount);
+        if (workload.columns.completionTime == NULL) {
+            fprintf(stderr, "Malloc failure: Process Array Not Copied\n");
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        ProcessColumns columns = {NULL, NULL, NULL, NULL, 0};
+        growColumns(&columns, processCount);
+        workload.columns = columns;
+    }
+
+    while (TRUE) {
+        pthread_mutex_lock(&run->lock);
+        int next = run->next++;
+        pthread_mutex_unlock(&run->lock);
+        if (next >= run->configCount) {
+            break;
+        }
+
+        memcpy(workload.processes, run->workload->processes, sizeof(Process) * processCount);
+        workload.admitted = 0;
+        if (!run->inOrder) {
+            memcpy(workload.columns.arrivalTime, run->workload->columns.arrivalTime, sizeof(long long) * processCount);
+            memcpy(workload.columns.serviceTime, run->workload->columns.serviceTime, sizeof(long long) * processCount);
+            memcpy(workload.columns.processName, run->workload->columns.processName, 
+                   sizeof(*workload.columns.processName) * processCount);
+            sortByArrival(&workload, run->configs[next].quantum);
+        }
+        run->results[next] = allocate(&workload, &run->configs[next], &quiet, NULL);
+    }
+
+    free(workload.processes);
+    if (run->inOrder) {
+        free(workload.columns.completionTime);
+    } else {
+        freeColumns(&workload.columns);
+    }
+    return NULL;
+}
+
+/* run worker on a pool of threads until it returns on each:
+    one thread per core unless requested, never more than there are jobs
+*/
+void runWorkers(int requested, int jobs, void* (*worker)(void*), void* arg) {
+    int threads = (requested > 0) ? requested : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > jobs) {
+        threads = jobs;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+    pthread_t* workers = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    if (workers == NULL) {
+        fprintf(stderr, "Malloc failure: Workers Not Initialized\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&workers[i], NULL, worker, arg) != 0) {
+            fprintf(stderr, "Failed to start worker\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+}
+
+/*******************************************************************************************************/
+/* Batch Mode
+
+    Simulates every input file as an independent run on a pool of threads. Each run has its own
+    workload, memory, cores and log writer, so runs share nothing but the batch cursor and event count.
+    A run's log goes to its own file under --output-dir, or else is copied to the standard output
+    in input order with every line tagged by its file, as soon as the runs before it are done.
+    No log is held open once its run ends, so a batch needs one descriptor per thread however many
+    files it has. The statistics of every run and of all runs together are reported at the end
+*/
+long long batch(Config* config, LogWriter* writer) {
+    Batch run;
+    run.config = config;
+    run.writer = writer;
+    run.next = run.copied = 0;
+    run.copying = FALSE;
+    run.results = (Statistics*)malloc(sizeof(Statistics) * config->fileCount);
+    run.logs = malloc(sizeof(*run.logs) * config->fileCount);
+    run.done = (int*)calloc(config->fileCount, sizeof(int));
+    if (run.results == NULL || run.logs == NULL || run.done == NULL) {
+        fprintf(stderr, "Malloc failure: Batch Not Initialized\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_mutex_init(&run.lock, NULL);
+    runWorkers(config->threads, config->fileCount, batchWorker, &run);
+
+    /* one row per run in input order, then the totals over every process of every run */
+    StatisticsTotals all = {0, 0, 0, 0, 0};
+    long long events = 0;
+    logString(writer, "file,processes,turnaround,max-overhead,avg-overhead,makespan\n");
+    for (int i = 0; i < config->fileCount; i++) {
+        StatisticsTotals* totals = &run.results[i].totals;
+        logBatchRow(writer, config->files[i], &run.results[i]);
+        events += run.results[i].events;
+        all.count += totals->count;
+        all.turnaround += totals->turnaround;
+        all.overhead += totals->overhead;
+        if (all.maxOverhead < totals->maxOverhead) {
+            all.maxOverhead = totals->maxOverhead;
+        }
+        if (all.makespan < totals->makespan) {
+            all.makespan = totals->makespan;
+        }
+    }
+    Statistics total = finishStatistics(&all);
+    logBatchRow(writer, "all", &total);
+
+    pthread_mutex_destroy(&run.lock);
+    free(run.results);
+    free(run.logs);
+    free(run.done);
+    return events;
+}
+
+/* take input files off the batch until none are left, simulating each as its own run
+*/
+void* batchWorker(void* arg) {
+    Batch* run = (Batch*)arg;
+    while (TRUE) {
+        pthread_mutex_lock(&run->lock);
+        int next = run->next++;
+        pthread_mutex_unlock(&run->lock);
+        if (next >= run->config->fileCount) {
+            break;
+        }
+
+        Config config = *run->config;
+        snprintf(config.filename, MAX_PATH_LEN, "%s", config.files[next]);
+
+        int fd;
+        if (config.outputDir[0] != '\0') {
+            char path[2 * MAX_PATH_LEN];
+            outputPath(path, config.outputDir, config.filename);
+            fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                perror(path);
+                exit(EXIT_FAILURE);
+            }
+        } else {
+            fd = temporaryLog(run->logs[next]);
+        }
+
+        LogWriter writer = {fd, config.events, config.frameRanges, 0};
+        Workload* workload = loadWorkload(&config);
+        run->results[next] = allocate(workload, &config, &writer, NULL);
+        printStatistics(&writer, &run->results[next]);
+        flushLog(&writer);
+        closeWorkload(workload);
+        close(fd);
+
+        if (config.outputDir[0] == '\0') {
+            pthread_mutex_lock(&run->lock);
+            run->done[next] = TRUE;
+            pthread_mutex_unlock(&run->lock);
+            copyFinished(run);
+        }
+    }
+    return NULL;
+}
+
+/* create an empty temporary file for a run's log, under TMPDIR or else /tmp */
+int temporaryLog(char path[]) {
+    const char* directory = getenv("TMPDIR");
+    snprintf(path, MAX_PATH_LEN, "%s/allocate-batch-XXXXXX", (directory != NULL) ? directory : "/tmp");
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+/* copy out the logs of every finished run that no earlier run is still holding back.
+    one worker copies at a time, outside the lock, and picks up the runs that finish while it does
+*/
+void copyFinished(Batch* run) {
+    pthread_mutex_lock(&run->lock);
+    if (run->copying) {
+        pthread_mutex_unlock(&run->lock);
+        return;
+    }
+    run->copying = TRUE;
+    while (run->copied < run->config->fileCount && run->done[run->copied]) {
+        int next = run->copied;
+        pthread_mutex_unlock(&run->lock);
+        copyTagged(run->writer, run->logs[next], run->config->files[next]);
+        flushLog(run->writer);
+        unlink(run->logs[next]);
+        pthread_mutex_lock(&run->lock);
+        run->copied++;
+    }
+    run->copying = FALSE;
+    pthread_mutex_unlock(&run->lock);
+}
+
+/* the file under directory a run's log is written to:
+    the input path with its directories joined by '_' and .txt replaced by .out
+*/
+void outputPath(char path[], const char* directory, const char* input) {
+    if (strncmp(input, "./", 2) == 0) {
+        input += 2;
+    }
+    int length = snprintf(path, 2 * MAX_PATH_LEN, "%s/%s", directory, input);
+    for (char* c = path + strlen(directory) + 1; *c != '\0'; c++) {
+        if (*c == '/') {
+            *c = '_';
+        }
+    }
+    if (length >= 4 && strcmp(path + length - 4, ".txt") == 0) {
+        length -= 4;
+    }
+    snprintf(path + length, 2 * MAX_PATH_LEN - length, ".out");
+}
+
+/* copy one run's log to the writer, starting every line with the run's input file
+*/
+void copyTagged(LogWriter* writer, const char* path, const char* tag) {
+    char chunk[LOG_BUFFER_SIZE];
+    int lineStart = TRUE;
+    size_t length;
+    FILE* output = fopen(path, "r");
+    if (output == NULL) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    while ((length = fread(chunk, 1, sizeof(chunk), output)) > 0) {
+        const char* cursor = chunk;
+        const char* end = chunk + length;
+        while (cursor < end) {
+            if (lineStart) {
+                logString(writer, tag);
+                logString(writer, ":");
+            }
+            const char* newline = memchr(cursor, '\n', end - cursor);
+            const char* stop = (newline == NULL) ? end : newline + 1;
+            logBytes(writer, cursor, stop - cursor);
+            lineStart = (newline != NULL);
+            cursor = stop;
+        }
+    }
+
+    fclose(output);
+
+    /* the statistics end without a newline */
+    if (!lineStart) {
+        logString(writer, "\n");
+    }
+}
+
+void logBatchRow(LogWriter* writer, const char* name, Statistics* statistics) {
+    char overhead[64];
+    snprintf(overhead, sizeof(overhead), ",%.2f,%.2f,", statistics->maxOverhead, statistics->avgOverhead);
+    logString(writer, name);
+    logString(writer, ",");
+    logInt(writer, statistics->totals.count);
+    logString(writer, ",");
+    logInt(writer, statistics->turnaround);
+    logString(writer, overhead);
+    logInt(writer, statistics->makespan);
+    logString(writer, "\n");
+}
+
+/*******************************************************************************************************/
+/* Scheduling Loop
+
+    Every memory strategy runs through the same loop. Each core has its own run queue and clock,
+    and the loop always advances the core that is furthest behind, so events are logged in time order
+    and a core always sees the shared memory as it stands at its own time.
+    A core with nothing it can run is parked until an arrival, freed memory or work to steal wakes it
+*/
+void simulate(Simulation* simulation) {
+    Workload* workload = simulation->workload;
+
+    /* loop will run until all processes are FINISHED*/
+    while (simulation->remaining > 0 || pendingArrivals(workload)) {
+        Core* core = nextCore(simulation);
+
+        /* the next quantum boundary at which a new arrival will be admitted */
+        long long horizon = nextArrivalBoundary(workload, simulation->quantum);
+
+        /* check if any new processes need to added to a run queue before this core's decision */
+        if (horizon != NO_EVENT && horizon <= core->time) {
+            checkProcesses(simulation, horizon);
+            continue;
+        }
+
+        /* every core is waiting for memory that nothing running will free */
+        if (core->time == PARKED) {
+            fprintf(stderr, "No waiting process fits in memory\n");
+            exit(EXIT_FAILURE);
+        }
+
+        /* a core with an empty run queue takes work from the busiest one */
+        long long time = core->time;
+        if (scheduledProcesses(core->scheduler) == 0) {
+            stealProcess(simulation, core);
+        }
+        runCore(simulation, core, horizon);
+
+        /* a core that ran out of work while another has READY processes steals one at the same time,
+            once the busy cores have decided; any other idle core waits to be woken */
+        if (core->idle) {
+            if (scheduledProcesses(core->scheduler) > 0 || stealVictim(simulation, core) == NULL) {
+                core->time = PARKED;
+            }
+        } else {
+            /* idle cores with empty run queues can take what this core left waiting */
+            int ready = readyProcesses(core->scheduler);
+            for (int i = 0; i < simulation->coreCount && ready > 0; i++) {
+                Core* other = &simulation->cores[i];
+                if (other->idle && scheduledProcesses(other->scheduler) == 0) {
+                    wakeCore(other, time);
+                    ready--;
+                }
+            }
+        }
+    }
+}
+
+/* an idle core looks at its run queue and memory again at time */
+void wakeCore(Core* core, long long time) {
+    if (core->idle && core->time > time) {
+        core->time = time;
+    }
+}
+
+/* the core whose clock is furthest behind. at equal times busy cores go first,
+    so an idle core only looks for work once every other core has made its decision
+*/
+Core* nextCore(Simulation* simulation) {
+    Core* next = &simulation->cores[0];
+    for (int i = 1; i < simulation->coreCount; i++) {
+        Core* core = &simulation->cores[i];
+        if (core->time < next->time || (core->time == next->time && next->idle && !core->idle)) {
+            next = core;
+        }
+    }
+    return next;
+}
+
+/* one scheduling decision on a core at its current time: the process whose slice just ended
+    is FINISHED or switched out, and the next slice is started, unless nothing on the core can run
+*/
+void runCore(Simulation* simulation, Core* core, long long horizon) {
+    Scheduler* scheduler = core->scheduler;
+    int quantum = simulation->quantum;
+    long long start = core->time;
+
+    /* isNew flag determines whether the process in the CPU was switched from READY to RUNNING */
+    int isNew = FALSE;
+
+    /* this is the first instruction call. It will determine what action to take for the quantum.
+        the instruction is either CONTINUE, FINISHED, or SWITCH*/
+    int instruction = CONTINUE;
+    Process* CPUproc = dispatch(simulation, core);
+    if (CPUproc != NULL) {
+        instruction = update(CPUproc, quantum, &core->time, &simulation->finished, scheduler, &isNew, 
+                             sliceHorizon(simulation, core, horizon));
+        if (isNew) {
+            startRunning(simulation, core, CPUproc);
+        }
+    }
+
+    /* a CONTINUE call indicates that update() allowed the current CPUproc to run for a quantum.
+        if not, there is a call to switch out the current CPUproc
+        or that the process has FINISHED at the end of the quantum */
+    while (instruction != CONTINUE) {
+        Process* sendBack = takeRunning(scheduler);
+
+        /* if process is FINISHED, its serviceTime has been completed
+            and it can be removed from the run queue */
+        if (sendBack->state == FINISHED) {
+            finishProcess(simulation, core, sendBack);
+
+        /* if instructions is SWITCH, 
+            which means that the current process has already run the last quantum, 
+            AND the policy prefers a READY process,
+            the CPU will switch out the process and send the current one back. */
+        } else if (instruction == SWITCH) {
+            switchOut(simulation, core, sendBack);
+        }
+
+        /* select the new process to run in the CPU, continuing as idle if there is none */
+        CPUproc = dispatch(simulation, core);
+        if (CPUproc == NULL) {
+            break;
+        }
+
+        /* This update call will only be done IF a new process is now in the CPU
+            or the current is allowed to continue, given no other ready processes, 
+            AND the process has been allocated memory */
+        instruction = update(CPUproc, quantum, &core->time, &simulation->finished, scheduler, &isNew, 
+                             sliceHorizon(simulation, core, horizon));
+        if (isNew) {
+            startRunning(simulation, core, CPUproc);
+        }
+    }
+
+    /* the clock only moves while a process runs */
+    core->busy += core->time - start;
+    core->idle = (scheduler->running == NULL);
+}
+
+/* the process a core runs next, once it holds its memory. processes that don't fit are deferred,
+    which under rr moves them to the back of the run queue; NULL once every one has been tried,
+    since only a process on another core can free the memory they are waiting for,
+    or while the core compacts memory for the process
+*/
+Process* dispatch(Simulation* simulation, Core* core) {
+    Scheduler* scheduler = core->scheduler;
+    int candidates = scheduledProcesses(scheduler);
+    Process* process;
+    long long time = core->time;
+
+    /* an indexed rr run queue passes over every process that doesn't fit at once,
+        counting the one at the front as the process blocked */
+    if (scheduler->index != NULL && scheduler->running == NULL) {
+        Process* first = firstRunIndex(scheduler->index);
+        scheduler->running = takeRunIndex(scheduler->index, largestRequest(&simulation->memory));
+        if (first != NULL && first != scheduler->running) {
+            blockedProcess(&simulation->memory, first);
+        }
+        if (scheduler->running == NULL) {
+            return NULL;
+        }
+    }
+    while ((process = runningProcess(scheduler)) != NULL) {
+        if (acquireMemory(simulation, core, process)) {
+            /* a compaction keeps the core busy, so the process starts when the core's clock comes round again */
+            return (core->time == time) ? process : NULL;
+        }
+        deferProcess(scheduler, takeRunning(scheduler), core->time);
+        if (--candidates == 0) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/* before running a process in CPU, check if it has allocated memory:
+    first-fit looks for a block it fits in, the buddy allocator splits the smallest free block that fits, paged memory evicts least recently used processes
+    until enough frames are free. FALSE if the process can't be given its memory yet
+*/
+int acquireMemory(Simulation* simulation, Core* core, Process* process) {
+    Memory* memory = &simulation->memory;
+    switch (memory->strategy) {
+        case MEMORY_FIRST_FIT:
+            if (process->FFmemoryAllocation == NOT_ALLOCATED) {
+                process->FFmemoryAllocation = allocateMemoryBlock(memory->extents, process->memoryRequirement);
+
+                /* enough is free, only not in one piece */
+                if (process->FFmemoryAllocation == NOT_ALLOCATED && memory->compactCost != NO_COMPACTION &&
+                        memory->extents->capacity - memory->extents->allocated >= process->memoryRequirement) {
+                    compactMemory(simulation, core);
+                    process->FFmemoryAllocation = allocateMemoryBlock(memory->extents, process->memoryRequirement);
+                }
+                if (process->FFmemoryAllocation == NOT_ALLOCATED) {
+                    blockedProcess(memory, process);
+                    return FALSE;
+                }
+                touchLRU(&memory->lru, process, core->time);
+                measureExtents(memory);
+            }
+            return TRUE;
+        case MEMORY_BUDDY:
+            if (process->FFmemoryAllocation == NOT_ALLOCATED) {
+                process->FFmemoryAllocation = allocateBuddyBlock(memory->buddy, process->memoryRequirement);
+                if (process->FFmemoryAllocation == NOT_ALLOCATED) {
+                    blockedProcess(memory, process);
+                    return FALSE;
+                }
+                measureExtents(memory);
+                measureRounding(memory, process, TRUE);
+            }
+            return TRUE;
+        case MEMORY_PAGED:
+            /* replacing single pages, every page has to be loaded before the process can run,
+                except under virtual memory where only its working set has to be */
+            if (memory->pages->replacement != REPLACEMENT_PROCESS) {
+                int minimum = memory->pages->workingSet;
+                if (minimum == 0) {
+                    minimum = pagesFor(memory->pages, process->memoryRequirement);
+                }
+                return acquirePages(simulation, core, process, minimum);
+            }
+            if (process->PmemoryAllocation != NULL && process->PmemoryAllocation[0] != NOT_ALLOCATED) {
+                return TRUE;
+            }
+            process->PmemoryAllocation = allocatePages(memory->pages, process->memoryRequirement, 
+                                                       process->PmemoryAllocation, &process->sizeOfFrames);
+
+            /* only evict when the frames of processes running on other cores leave enough room */
+            if (process->PmemoryAllocation[0] == NOT_ALLOCATED && 
+                    process->sizeOfFrames > memory->pages->frameCount - runningFrames(simulation)) {
+                blockedProcess(memory, process);
+                return FALSE;
+            }
+            while (process->PmemoryAllocation[0] == NOT_ALLOCATED) {
+                if (!evictLRU(memory, core->time, simulation->writer, coreTag(simulation, core))) {
+                    blockedProcess(memory, process);
+                    return FALSE;
+                }
+                simulation->events++;
+                process->PmemoryAllocation = allocatePages(memory->pages, process->memoryRequirement, 
+                                                           process->PmemoryAllocation, &process->sizeOfFrames);
+            }
+            process->residentFrames = process->sizeOfFrames;
+            memory->metrics.pageFaults += process->sizeOfFrames;
+            measureRounding(memory, process, TRUE);
+            return TRUE;
+        default:
+            return TRUE;
+    }
+}
+
+/* a process was switched from READY to RUNNING for its first quantum:
+    mark it as used and print out a message
+*/
+void startRunning(Simulation* simulation, Core* core, Process* process) {
+    Memory* memory = &simulation->memory;
+    LogWriter* writer = simulation->writer;
+    int quantum = simulation->quantum;
+    long long time = core->time - quantum;
+
+    if (memory->strategy == MEMORY_PAGED) {
+        touchLRU(&memory->lru, process, time);
+    }
+    simulation->events++;
+    if (process->firstRun == NOT_ALLOCATED) {
+        process->firstRun = time;
+    }
+    if (simulation->plan != NULL) {
+        if (simulation->plan->recording) {
+            recordStart(simulation->plan, process->id, time);
+        } else {
+            simulation->plan->next[process->id]++;
+        }
+    }
+    if (!writer->events) {
+        return;
+    }
+
+    /* decrement time in message in accordance with quantum */
+    logRunning(writer, time, simulation->workload->columns.processName[process->id], process->remainingTime + quantum);
+    if (memory->strategy == MEMORY_FIRST_FIT) {
+        logString(writer, ",mem-usage=");
+        logInt(writer, calculateMemUsage(memory->extents));
+        logString(writer, "%,allocated-at=");
+        logInt(writer, process->FFmemoryAllocation);
+    } else if (memory->strategy == MEMORY_BUDDY) {
+        logString(writer, ",mem-usage=");
+        logInt(writer, calculateBuddyMemUsage(memory->buddy));
+        logString(writer, "%,allocated-at=");
+        logInt(writer, process->FFmemoryAllocation);
+    } else if (memory->strategy == MEMORY_PAGED) {
+        logString(writer, ",mem-usage=");
+        logInt(writer, calculatePageMemUsage(memory->pages));
+        logString(writer, "%,mem-frames=");
+        if (memory->pages->replacement == REPLACEMENT_PROCESS) {
+            logFrames(writer, process->PmemoryAllocation, process->sizeOfFrames);
+        } else {
+            logFrames(writer, sortedFrames(process, memory->pages->scratch), process->residentFrames);
+        }
+    }
+    if (simulation->memoryStats) {
+        logMemoryMetrics(writer, &memory->metrics);
+    }
+    logEventEnd(writer, coreTag(simulation, core));
+}
+
+/* free the memory of a FINISHED process and record its completion
+*/
+void finishProcess(Simulation* simulation, Core* core, Process* process) {
+    Memory* memory = &simulation->memory;
+    LogWriter* writer = simulation->writer;
+    Workload* workload = simulation->workload;
+    long long time = core->time;
+    int tag = coreTag(simulation, core);
+
+    if (memory->strategy == MEMORY_FIRST_FIT) {
+        deallocateMemoryBlock(memory->extents, process->FFmemoryAllocation, process->memoryRequirement);
+        removeLRU(&memory->lru, process);
+        measureExtents(memory);
+        releaseMemory(simulation, time);
+    } else if (memory->strategy == MEMORY_BUDDY) {
+        deallocateBuddyBlock(memory->buddy, process->FFmemoryAllocation, process->memoryRequirement);
+        measureExtents(memory);
+        measureRounding(memory, process, FALSE);
+        releaseMemory(simulation, time);
+    } else if (memory->strategy == MEMORY_PAGED && memory->pages->replacement != REPLACEMENT_PROCESS) {
+        logEvicted(writer, time, sortedFrames(process, memory->pages->scratch), process->residentFrames, tag);
+        simulation->events++;
+
+        unloadPages(memory, process);
+        giveFrameList(&simulation->arena, process->PmemoryAllocation, process->sizeOfFrames);
+        process->PmemoryAllocation = NULL;
+        releaseMemory(simulation, time);
+    } else if (memory->strategy == MEMORY_PAGED) {
+        logEvicted(writer, time, process->PmemoryAllocation, process->sizeOfFrames, tag);
+        simulation->events++;
+
+        measureRounding(memory, process, FALSE);
+        deallocatePages(memory->pages, &process->sizeOfFrames, process->PmemoryAllocation);
+        process->residentFrames = 0;
+        removeLRU(&memory->lru, process);
+        giveFrameList(&simulation->arena, process->PmemoryAllocation, process->sizeOfFrames);
+        process->PmemoryAllocation = NULL;
+        releaseMemory(simulation, time);
+    }
+
+    simulation->remaining--;
+    logFinished(writer, time, workload->columns.processName[process->id], simulation->remaining, tag);
+    simulation->events++;
+    if (simulation->latency != NULL || simulation->records != NULL) {
+        recordLatency(simulation, process, time);
+    }
+    retireProcess(workload, process, time);
+}
+
+/* send a process that used up its slice back to its core's run queue
+*/
+void switchOut(Simulation* simulation, Core* core, Process* process) {
+    Memory* memory = &simulation->memory;
+    if (memory->strategy == MEMORY_PAGED) {
+        touchLRU(&memory->lru, process, core->time);
+    }
+    process->state = READY;
+    process->preemptions++;
+    makeReady(core->scheduler, process, core->time);
+
+    /* out of the CPU its frames can be evicted again, which may be all a deferred process was waiting for */
+    if (memory->strategy == MEMORY_PAGED) {
+        releaseMemory(simulation, core->time);
+    }
+}
+
+/* frames held by processes RUNNING on a core, which can't be evicted */
+int runningFrames(Simulation* simulation) {
+    int frames = 0;
+    for (int i = 0; i < simulation->coreCount; i++) {
+        Process* running = simulation->cores[i].scheduler->running;
+        if (running != NULL && running->state == RUNNING) {
+            frames += running->residentFrames;
+        }
+    }
+    return frames;
+}
+
+/* memory is shared, so memory freed on one core gives processes waiting on every core another chance,
+    though only those that could now fit, and only as many as the free memory could hold between them.
+    a process released on a busy core would wait for its slice to end, so idle cores with empty run queues
+    are woken to steal it
+*/
+void releaseMemory(Simulation* simulation, long long time) {
+    long long largest = largestRequest(&simulation->memory);
+    long long room = freeMemory(&simulation->memory);
+    int released = 0;
+    for (int i = 0; i < simulation->coreCount; i++) {
+        Core* core = &simulation->cores[i];
+        released += releaseDeferred(core->scheduler, time, largest, &room);
+        if (scheduledProcesses(core->scheduler) > 0) {
+            wakeCore(core, time);
+        }
+    }
+    for (int i = 0; i < simulation->coreCount && released > 0; i++) {
+        Core* core = &simulation->cores[i];
+        if (core->idle && scheduledProcesses(core->scheduler) == 0) {
+            wakeCore(core, time);
+            released--;
+        }
+    }
+}
+
+/* how far a core can commit the running process's slice: up to the next arrival, and while the core has
+    deferred processes, no further than the next decision of another busy core, which could free the memory
+    they wait for. a slice always runs at least one quantum
+*/
+long long sliceHorizon(Simulation* simulation, Core* core, long long horizon) {
+    if (core->scheduler->deferred.size == 0) {
+        return horizon;
+    }
+    int quantum = simulation->quantum;
+    for (int i = 0; i < simulation->coreCount; i++) {
+        Core* other = &simulation->cores[i];
+        if (other == core || other->idle) {
+            continue;
+        }
+        long long release = core->time + quantum;
+        if (other->time > release) {
+            release = core->time + (other->time - core->time + quantum - 1) / quantum * quantum;
+        }
+        if (horizon == NO_EVENT || release < horizon) {
+            horizon = release;
+        }
+    }
+    return horizon;
+}
+
+/* the most memory a process could be given now: the largest hole, which compaction would make
+    all free memory, or the largest free buddy block. paged memory can evict, so any process might fit
+*/
+long long largestRequest(Memory* memory) {
+    switch (memory->strategy) {
+        case MEMORY_FIRST_FIT:
+            if (memory->compactCost != NO_COMPACTION) {
+                return memory->extents->capacity - memory->extents->allocated;
+            }
+            return (memory->extents->root == NOT_ALLOCATED) ? 0 : memory->extents->nodes[memory->extents->root].largest;
+        case MEMORY_BUDDY:
+            return largestBuddyBlock(memory->buddy);
+        default:
+            return LLONG_MAX;
+    }
+}
+
+/* the memory free in total under first-fit or buddy memory. paged memory can evict, so it is unbounded */
+long long freeMemory(Memory* memory) {
+    switch (memory->strategy) {
+        case MEMORY_FIRST_FIT:
+            return memory->extents->capacity - memory->extents->allocated;
+        case MEMORY_BUDDY:
+            return memory->buddy->capacity - memory->buddy->allocated;
+        default:
+            return LLONG_MAX;
+    }
+}
+
+/* the core with the most READY processes, which an idle core steals from; NULL if no other core has any */
+Core* stealVictim(Simulation* simulation, Core* thief) {
+    Core* victim = NULL;
+    int most = 0;
+    for (int i = 0; i < simulation->coreCount; i++) {
+        Core* core = &simulation->cores[i];
+        int ready = readyProcesses(core->scheduler);
+        if (core != thief && ready > most) {
+            victim = core;
+            most = ready;
+        }
+    }
+    return victim;
+}
+
+/* an idle core takes the process the core with the most READY processes would run next.
+    running and deferred processes stay where they are
+*/
+void stealProcess(Simulation* simulation, Core* thief) {
+    Core* victim = stealVictim(simulation, thief);
+    if (victim != NULL) {
+        makeReady(thief->scheduler, pickNext(victim->scheduler), thief->time);
+    }
+}
+
+/* the core id event lines are tagged with, only when simulating more than one core */
+int coreTag(Simulation* simulation, Core* core) {
+    return (simulation->coreCount > 1) ? core->id : NO_CORE;
+}
+
+/*Evict pages of least recently used processor that isn't RUNNING on another core,
+    which on a single core is always the head of the LRU list. FALSE if there is none
+*/
+int evictLRU(Memory* memory, long long time, LogWriter* writer, int core){
+    Process* victim = memory->lru.head;
+    while (victim != NULL && victim->state == RUNNING) {
+        victim = victim->lruNext;
+    }
+    if (victim == NULL) {
+        return FALSE;
+    }
+
+    logEvicted(writer, time, victim->PmemoryAllocation, victim->sizeOfFrames, core);
+
+    memory->metrics.evictions++;
+    memory->metrics.evictedFrames += victim->sizeOfFrames;
+    measureRounding(memory, victim, FALSE);
+    deallocatePages(memory->pages,&victim->sizeOfFrames, victim->PmemoryAllocation);
+    victim->residentFrames = 0;
+    removeLRU(&memory->lru, victim);
+    return TRUE;
+}
+
+/*******************************************************************************************************/
+/* Compaction
+
+    First-fit memory slides every block down to the lowest addresses, leaving one hole at the top.
+    The blocks are sorted by address with a radix sort, so a compaction is linear in the number of blocks,
+    and the core is charged compactCost per KB moved, rounded up to whole quanta,
+    before the process it compacted for starts. Blocks of processes running on other cores move too
+*/
+void compactMemory(Simulation* simulation, Core* core) {
+    Memory* memory = &simulation->memory;
+    FreeExtentTree* extents = memory->extents;
+
+    /* the sort needs room for two copies of the block list */
+    int count = 0;
+    for (Process* process = memory->lru.head; process != NULL; process = process->lruNext) {
+        count++;
+    }
+    if (count * 2 > memory->blockCapacity) {
+        memory->blocks = (Process**)arenaGrow(&simulation->arena, memory->blocks, 
+                                              sizeof(Process*) * memory->blockCapacity, sizeof(Process*) * count * 4);
+        memory->blockCapacity = count * 4;
+    }
+    count = 0;
+    for (Process* process = memory->lru.head; process != NULL; process = process->lruNext) {
+        memory->blocks[count++] = process;
+    }
+    Process** blocks = sortBlocks(memory->blocks, memory->blocks + count, count, extents->capacity);
+
+    long long address = 0, moved = 0;
+    for (int i = 0; i < count; i++) {
+        if (blocks[i]->FFmemoryAllocation != address) {
+            blocks[i]->FFmemoryAllocation = address;
+            moved += blocks[i]->memoryRequirement;
+        }
+        address += blocks[i]->memoryRequirement;
+    }
+    compactFreeExtents(extents);
+
+    long long cost = (long long)ceil(moved * memory->compactCost);
+    cost = ((cost + simulation->quantum - 1) / simulation->quantum) * simulation->quantum;
+    logCompacted(simulation->writer, core->time, moved, cost, coreTag(simulation, core));
+    simulation->events++;
+    core->time += cost;
+
+    memory->metrics.compactions++;
+    memory->metrics.compactedKB += moved;
+    memory->metrics.compactionTime += cost;
+}
+
+/* sort blocks by address a byte at a time, least significant first, using sorted as the other buffer;
+    only as many bytes as capacity needs are sorted on. returns whichever buffer holds the result
+*/
+Process** sortBlocks(Process** blocks, Process** sorted, int count, long long capacity) {
+    for (int shift = 0; ((capacity - 1) >> shift) > 0; shift += 8) {
+        int counts[257] = {0};
+        for (int i = 0; i < count; i++) {
+            counts[((blocks[i]->FFmemoryAllocation >> shift) & 0xFF) + 1]++;
+        }
+        for (int digit = 0; digit < 256; digit++) {
+            counts[digit + 1] += counts[digit];
+        }
+        for (int i = 0; i < count; i++) {
+            sorted[counts[(blocks[i]->FFmemoryAllocation >> shift) & 0xFF]++] = blocks[i];
+        }
+        Process** swap = blocks;
+        blocks = sorted;
+        sorted = swap;
+    }
+    return blocks;
+}
+
+/*******************************************************************************************************/
+/* Page Replacement
+
+    With a replacement policy other than whole processes, paged memory loads and evicts single pages.
+    A process's page table keeps the frame of each of its pages, each frame its owner and page,
+    so a page is evicted in O(1) and only as many pages are evicted as the process needs.
+    Pages of RUNNING processes, and of the process being loaded, are never evicted
+*/
+/* load the process's missing pages until at least minimum are resident, as many as are free,
+    evicting only the shortfall. FALSE if the frames of running processes leave too little room
+*/
+int acquirePages(Simulation* simulation, Core* core, Process* process, int minimum) {
+    Memory* memory = &simulation->memory;
+    FrameTable* pages = memory->pages;
+
+    /* the page table is sized once and kept across evictions */
+    if (process->PmemoryAllocation == NULL) {
+        process->sizeOfFrames = pagesFor(pages, process->memoryRequirement);
+        process->PmemoryAllocation = takeFrameList(&simulation->arena, process->sizeOfFrames);
+        for (int i = 0; i < process->sizeOfFrames; i++) {
+            process->PmemoryAllocation[i] = NOT_ALLOCATED;
+        }
+        process->residentFrames = 0;
+    }
+    if (minimum > process->sizeOfFrames) {
+        minimum = process->sizeOfFrames;
+    }
+    if (process->residentFrames >= minimum) {
+        return TRUE;
+    }
+
+    int available = pages->frameCount - pages->allocated;
+    if (process->residentFrames + available < minimum) {
+        if (minimum > pages->frameCount - runningFrames(simulation)) {
+            blockedProcess(memory, process);
+            return FALSE;
+        }
+        evictPages(simulation, core, process, minimum - process->residentFrames - available);
+        available = pages->frameCount - pages->allocated;
+    }
+
+    int missing = process->sizeOfFrames - process->residentFrames;
+    loadPages(memory, process, (missing < available) ? missing : available, core->time);
+    return TRUE;
+}
+
+/* load count of the process's missing pages, lowest first, into the lowest free frames */
+void loadPages(Memory* memory, Process* process, int count, long long time) {
+    FrameTable* pages = memory->pages;
+    if (count <= 0) {
+        return;
+    }
+    if (process->residentFrames == 0) {
+        measureRounding(memory, process, TRUE);
+    }
+
+    takeFrames(pages, count, pages->scratch);
+    int loaded = 0;
+    for (int i = 0; i < process->sizeOfFrames && loaded < count; i++) {
+        if (process->PmemoryAllocation[i] != NOT_ALLOCATED) {
+            continue;
+        }
+        int frame = pages->scratch[loaded++];
+        process->PmemoryAllocation[i] = frame;
+        pages->owner[frame] = process;
+        pages->page[frame] = i;
+
+        /* fifo appends the frame as the newest, clock counts the load as its last clearing */
+        if (pages->older != NULL) {
+            pages->older[frame] = pages->newest;
+            pages->newer[frame] = NOT_ALLOCATED;
+            if (pages->newest != NOT_ALLOCATED) {
+                pages->newer[pages->newest] = frame;
+            } else {
+                pages->oldest = frame;
+            }
+            pages->newest = frame;
+        }
+        if (pages->cleared != NULL) {
+            pages->cleared[frame] = time;
+        }
+    }
+    process->residentFrames += count;
+    memory->metrics.pageFaults += count;
+}
+
+/* evict count pages chosen by the replacement policy, logged as one EVICTED line */
+void evictPages(Simulation* simulation, Core* core, Process* requester, int count) {
+    Memory* memory = &simulation->memory;
+    FrameTable* pages = memory->pages;
+    int evicted = 0;
+
+    while (evicted < count) {
+        /* lru and opt pick a process, all of whose pages were last used together, and take its lowest frames.
+            they are sorted in place after the frames already evicted, and the ones not taken are overwritten */
+        if (pages->replacement == REPLACEMENT_LRU || pages->replacement == REPLACEMENT_OPT) {
+            Process* victim = victimProcess(simulation, requester);
+            int* frames = sortedFrames(victim, pages->scratch + evicted);
+            int taken = (victim->residentFrames < count - evicted) ? victim->residentFrames : count - evicted;
+            for (int i = 0; i < taken; i++) {
+                evictFrame(memory, frames[i]);
+            }
+            evicted += taken;
+        } else {
+            int frame = victimFrame(memory, requester, core->time);
+            pages->scratch[evicted++] = frame;
+            evictFrame(memory, frame);
+        }
+    }
+
+    memory->metrics.evictions++;
+    memory->metrics.evictedFrames += evicted;
+    qsort(pages->scratch, evicted, sizeof(int), compareFrames);
+    logEvicted(simulation->writer, core->time, pages->scratch, evicted, coreTag(simulation, core));
+    simulation->events++;
+}
+
+/* take one page out of its frame, dropping its owner from the LRU list once nothing of it is resident */
+void evictFrame(Memory* memory, int frame) {
+    FrameTable* pages = memory->pages;
+    Process* owner = pages->owner[frame];
+    owner->PmemoryAllocation[pages->page[frame]] = NOT_ALLOCATED;
+    owner->residentFrames--;
+    releaseFrame(pages, frame);
+    if (owner->residentFrames == 0) {
+        removeLRU(&memory->lru, owner);
+        measureRounding(memory, owner, FALSE);
+    }
+}
+
+/* free every resident page of a FINISHED process */
+void unloadPages(Memory* memory, Process* process) {
+    for (int i = 0; i < process->sizeOfFrames && process->residentFrames > 0; i++) {
+        if (process->PmemoryAllocation[i] != NOT_ALLOCATED) {
+            evictFrame(memory, process->PmemoryAllocation[i]);
+        }
+    }
+}
+
+/* the resident process whose pages go next: the least recently used for lru,
+    the one that runs again furthest in the future for opt, ties going to the least recently used
+*/
+Process* victimProcess(Simulation* simulation, Process* requester) {
+    Process* victim = NULL;
+    long long furthest = NOT_ALLOCATED;
+    for (Process* process = simulation->memory.lru.head; process != NULL; process = process->lruNext) {
+        if (process->state == RUNNING || process == requester) {
+            continue;
+        }
+        if (simulation->memory.pages->replacement == REPLACEMENT_LRU) {
+            return process;
+        }
+        long long use = nextUse(simulation->plan, process);
+        if (use > furthest) {
+            victim = process;
+            furthest = use;
+        }
+    }
+    return victim;
+}
+
+/* the frame fifo or clock evicts next. fifo takes the longest resident page, clock sweeps its hand
+    round the frames, giving a page used since it was last cleared a second chance
+*/
+int victimFrame(Memory* memory, Process* requester, long long time) {
+    FrameTable* pages = memory->pages;
+    if (pages->replacement == REPLACEMENT_FIFO) {
+        int frame = pages->oldest;
+        while (pages->owner[frame]->state == RUNNING || pages->owner[frame] == requester) {
+            frame = pages->newer[frame];
+        }
+        return frame;
+    }
+
+    while (TRUE) {
+        int frame = pages->hand;
+        pages->hand = (pages->hand + 1) % pages->frameCount;
+        Process* owner = pages->owner[frame];
+        if (owner == NULL || owner->state == RUNNING || owner == requester) {
+            continue;
+        }
+        if (owner->lastUsed > pages->cleared[frame]) {
+            pages->cleared[frame] = time;
+            continue;
+        }
+        return frame;
+    }
+}
+
+/* the process's resident frames in ascending order, written into frames */
+int* sortedFrames(Process* process, int* frames) {
+    int count = 0;
+    for (int i = 0; i < process->sizeOfFrames && count < process->residentFrames; i++) {
+        if (process->PmemoryAllocation[i] != NOT_ALLOCATED) {
+            frames[count++] = process->PmemoryAllocation[i];
+        }
+    }
+    qsort(frames, count, sizeof(int), compareFrames);
+    return frames;
+}
+
+int compareFrames(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+/*******************************************************************************************************/
+/* Future Plan
+
+    opt evicts the pages used furthest in the future. Paged memory never changes the order processes
+    run in on one core, so a run of the same workload with infinite memory, recording when each process
+    starts RUNNING, gives the exact future; with more cores it is an estimate
+*/
+FuturePlan* planFutureUse(Arena* arena, Workload* workload, Config* config) {
+    if (workload->streaming) {
+        fprintf(stderr, "opt replacement needs the whole workload and can't be streamed\n");
+        exit(EXIT_FAILURE);
+    }
+    int processCount = workload->processCount;
+    FuturePlan* plan = (FuturePlan*)arenaAlloc(arena, sizeof(FuturePlan));
+    plan->processCount = processCount;
+    plan->recording = TRUE;
+
+    /* the recording run works on a private copy of the process state */
+    Workload copy = *workload;
+    copy.processes = (Process*)malloc(sizeof(Process) * processCount);
+    copy.columns.completionTime = (long long*)malloc(sizeof(long long) * processCount);
+    if (copy.processes == NULL || copy.columns.completionTime == NULL) {
+        fprintf(stderr, "Malloc failure: Process Array Not Copied\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(copy.processes, workload->processes, sizeof(Process) * processCount);
+    copy.admitted = 0;
+
+    Config infinite = *config;
+    snprintf(infinite.memoryStrategy, MAX_FILENAME_STRATEGY_LEN, "%s", INFINITE_MEMORY);
+    infinite.latency = FALSE;
+    infinite.latencyCsv[0] = '\0';
+    LogWriter quiet = {STDOUT_FILENO, FALSE, FALSE, 0};
+    allocate(&copy, &infinite, &quiet, plan);
+    free(copy.processes);
+    free(copy.columns.completionTime);
+
+    /* group the starts by process, keeping each process's in time order */
+    plan->times = (long long*)arenaAlloc(arena, sizeof(long long) * (plan->recordCount + 1));
+    plan->first = (long long*)arenaAlloc(arena, sizeof(long long) * (processCount + 1));
+    plan->next = (long long*)arenaAlloc(arena, sizeof(long long) * (processCount + 1));
+    for (long long i = 0; i < plan->recordCount; i++) {
+        plan->first[plan->recordIds[i] + 1]++;
+    }
+    for (int id = 0; id < processCount; id++) {
+        plan->first[id + 1] += plan->first[id];
+        plan->next[id] = plan->first[id];
+    }
+    for (long long i = 0; i < plan->recordCount; i++) {
+        plan->times[plan->next[plan->recordIds[i]]++] = plan->recordTimes[i];
+    }
+    for (int id = 0; id < processCount; id++) {
+        plan->next[id] = plan->first[id];
+    }
+    free(plan->recordIds);
+    free(plan->recordTimes);
+    plan->recording = FALSE;
+    return plan;
+}
+
+/* append one start to the plan being recorded */
+void recordStart(FuturePlan* plan, int id, long long time) {
+    if (plan->recordCount == plan->recordCapacity) {
+        plan->recordCapacity = (plan->recordCapacity == 0) ? INITIAL_PROCESSES : plan->recordCapacity * 2;
+        plan->recordIds = (int*)realloc(plan->recordIds, sizeof(int) * plan->recordCapacity);
+        plan->recordTimes = (long long*)realloc(plan->recordTimes, sizeof(long long) * plan->recordCapacity);
+        if (plan->recordIds == NULL || plan->recordTimes == NULL) {
+            fprintf(stderr, "Realloc failure: Future Plan not reallocated in memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    plan->recordIds[plan->recordCount] = id;
+    plan->recordTimes[plan->recordCount] = time;
+    plan->recordCount++;
+}
+
+/* when a READY process next starts RUNNING, or never if it won't */
+long long nextUse(FuturePlan* plan, Process* process) {
+    if (plan->next[process->id] < plan->first[process->id + 1]) {
+        return plan->times[plan->next[process->id]];
+    }
+    return PARKED;
+}
+
+/* mark a resident process as used at time, moving it after every process used no later.
+    cores make their decisions in time order, so that is normally the tail; but a core that
+    compacts memory touches at its clock after the compaction, ahead of the other cores' clocks,
+    so a touch can land before the tail and walks back past the processes touched since
+*/
+void touchLRU(LRUList* lru, Process* process, long long time) {
+    removeLRU(lru, process);
+    process->lastUsed = time;
+    Process* before = lru->tail;
+    while (before != NULL && before->lastUsed > time) {
+        before = before->lruPrev;
+    }
+    process->lruPrev = before;
+    process->lruNext = (before != NULL) ? before->lruNext : lru->head;
+    if (before != NULL) {
+        before->lruNext = process;
+    } else {
+        lru->head = process;
+    }
+    if (process->lruNext != NULL) {
+        process->lruNext->lruPrev = process;
+    } else {
+        lru->tail = process;
+    }
+}
+
+/* unlink a process from the LRU list once it no longer holds frames */
+void removeLRU(LRUList* lru, Process* process) {
+    if (process->lruPrev == NULL && lru->head != process) {
+        return;
+    }
+    if (process->lruPrev != NULL) {
+        process->lruPrev->lruNext = process->lruNext;
+    } else {
+        lru->head = process->lruNext;
+    }
+    if (process->lruNext != NULL) {
+        process->lruNext->lruPrev = process->lruPrev;
+    } else {
+        lru->tail = process->lruPrev;
+    }
+    process->lruPrev = process->lruNext = NULL;
+}
+
+/* the free runs after a first-fit or buddy allocation or free: how many there are, the largest,
+    and the share of free memory outside the largest, which a request can't use in one piece
+*/
+void measureExtents(Memory* memory) {
+    FreeExtentTree* extents = memory->extents;
+    BuddyAllocator* buddy = memory->buddy;
+    MemoryMetrics* metrics = &memory->metrics;
+    long long available;
+
+    if (buddy != NULL) {
+        available = buddy->capacity - buddy->allocated;
+        metrics->holes = buddy->holes;
+        metrics->largestHole = largestBuddyBlock(buddy);
+    } else {
+        available = extents->capacity - extents->allocated;
+        metrics->holes = extents->holes;
+        metrics->largestHole = (extents->root == NOT_ALLOCATED) ? 0 : extents->nodes[extents->root].largest;
+    }
+    metrics->external = (available > 0) ? 1 - (double)metrics->largestHole / available : 0;
+    if (metrics->maxHoles < metrics->holes) {
+        metrics->maxHoles = metrics->holes;
+    }
+    if (metrics->maxExternal < metrics->external) {
+        metrics->maxExternal = metrics->external;
+    }
+}
+
+/* the KB of a process's last page or buddy block it doesn't use, counted while it holds its memory */
+void measureRounding(Memory* memory, Process* process, int resident) {
+    MemoryMetrics* metrics = &memory->metrics;
+    long long held = (memory->strategy == MEMORY_BUDDY) ? 1LL << buddyOrder(process->memoryRequirement)
+                                                         : (long long)process->sizeOfFrames * memory->pages->pageSize;
+    long long rounding = held - process->memoryRequirement;
+    metrics->internal += resident ? rounding : -rounding;
+    if (metrics->maxInternal < metrics->internal) {
+        metrics->maxInternal = metrics->internal;
+    }
+}
+
+/* a process couldn't be given its memory: first-fit or buddy memory with enough free in total is fragmented */
+void blockedProcess(Memory* memory, Process* process) {
+    FreeExtentTree* extents = memory->extents;
+    BuddyAllocator* buddy = memory->buddy;
+    if ((extents != NULL && extents->capacity - extents->allocated >= process->memoryRequirement) ||
+            (buddy != NULL && buddy->capacity - buddy->allocated >= process->memoryRequirement)) {
+        memory->metrics.fragmentationBlocks++;
+    } else {
+        memory->metrics.capacityBlocks++;
+    }
+}
+
+/* calculate percentage of total memory used, rounded up
+*/
+int calculateMemUsage(FreeExtentTree* memory) {
+    double usage = memory->allocated;
+    usage = ceil((usage / memory->capacity) * 100);
+
+    return (int)usage;
+}
+
+int calculatePageMemUsage(FrameTable* pages) {
+    double usage = pages->allocated;
+    usage = ceil((usage / pages->frameCount) * 100);
+
+    return (int)usage;
+}
+
+/* buddy memory in use counts whole blocks, including what each process doesn't use of its block */
+int calculateBuddyMemUsage(BuddyAllocator* buddy) {
+    double usage = buddy->allocated;
+    usage = ceil((usage / buddy->capacity) * 100);
+
+    return (int)usage;
+}
+
+/* Free the block of memory associate with a process,
+    coalescing it with the free runs directly before and after it
+*/
+void deallocateMemoryBlock(FreeExtentTree* memory, long long allocationStart, long long allocationSize) {
+    int before, after, neighbour;
+    long long start = allocationStart, length = allocationSize;
+    splitFreeExtents(memory, memory->root, allocationStart, &before, &after);
+
+    /* free run ending where the block starts */
+    if (before != NOT_ALLOCATED) {
+        before = popFreeExtent(memory, before, TRUE, &neighbour);
+        FreeExtent* run = &memory->nodes[neighbour];
+        if (run->start + run->length == start) {
+            start = run->start;
+            length += run->length;
+            releaseFreeExtent(memory, neighbour);
+        } else {
+            before = mergeFreeExtents(memory, before, neighbour);
+        }
+    }
+
+    /* free run starting where the block ends */
+    if (after != NOT_ALLOCATED) {
+        after = popFreeExtent(memory, after, FALSE, &neighbour);
+        FreeExtent* run = &memory->nodes[neighbour];
+        if (allocationStart + allocationSize == run->start) {
+            length += run->length;
+            releaseFreeExtent(memory, neighbour);
+        } else {
+            after = mergeFreeExtents(memory, neighbour, after);
+        }
+    }
+
+    int block = newFreeExtent(memory, start, length);
+    memory->root = mergeFreeExtents(memory, mergeFreeExtents(memory, before, block), after);
+    memory->allocated -= allocationSize;
+}
+
+/*Free the pages associate with a process */
+void deallocatePages(FrameTable* pages, int* frameSize, int* frames){
+    for(int i=0; i< *frameSize; i++){
+        freeFrame(pages, frames[i]);
+        frames[i] = NOT_ALLOCATED;
+    }
+    pages->allocated -= *frameSize;
+}
+
+/* clear a frame's bit, and its word's in the summary */
+void freeFrame(FrameTable* pages, int frame) {
+    int word = frame / 64;
+    pages->frames[word] &= ~((uint64_t)1 << (frame % 64));
+    pages->full[word / 64] &= ~((uint64_t)1 << (word % 64));
+    if (word / 64 < pages->searchFrom) {
+        pages->searchFrom = word / 64;
+    }
+}
+
+/* free a single page's frame, taking it out of the load order */
+void releaseFrame(FrameTable* pages, int frame) {
+    freeFrame(pages, frame);
+    pages->allocated--;
+    pages->owner[frame] = NULL;
+    if (pages->older != NULL) {
+        int older = pages->older[frame], newer = pages->newer[frame];
+        if (older != NOT_ALLOCATED) {
+            pages->newer[older] = newer;
+        } else {
+            pages->oldest = newer;
+        }
+        if (newer != NOT_ALLOCATED) {
+            pages->older[newer] = older;
+        } else {
+            pages->newest = older;
+        }
+    }
+}
+
+/* Allocate a contiguous block of memory for a process,
+    from the start of the lowest addressed free run that fits
+*/    
+long long allocateMemoryBlock(FreeExtentTree* memory, long long memoryRequirement) {
+    
+    long long memoryAllocation = NOT_ALLOCATED;
+
+    /* the root holds the largest free run, so a request that cannot fit is rejected immediately */
+    if (memory->root == NOT_ALLOCATED || memory->nodes[memory->root].largest < memoryRequirement) {
+        return NOT_ALLOCATED;
+    }
+
+    memory->root = takeFirstFit(memory, memory->root, memoryRequirement, &memoryAllocation);
+    memory->allocated += memoryRequirement;
+    return memoryAllocation;
+}
+/* Allocates the lowest numbered free frames for a process into its frame list, 
+    which is taken from the arena on the first attempt and reused after every eviction
+*/
+int* allocatePages(FrameTable* pages, long long memoryRequirement, int* frames, int* frameSize) {
+
+    int pagesRequired = pagesFor(pages, memoryRequirement);
+
+    *frameSize = pagesRequired;
+    if (frames == NULL) {
+        frames = takeFrameList(pages->arena, pagesRequired);
+        for(int i = 0; i< pagesRequired ; i++){
+            frames[i] = NOT_ALLOCATED;
+        }
+    }
+
+    /* not enough free frames in total, the frames stay unallocated */
+    if (pages->frameCount - pages->allocated < pagesRequired) {
+        return frames;
+    }
+    takeFrames(pages, pagesRequired, frames);
+    return frames;
+}
+
+/* pages needed to hold memoryRequirement KB */
+int pagesFor(FrameTable* pages, long long memoryRequirement) {
+    if(memoryRequirement % pages->pageSize == 0 ){
+        return memoryRequirement/pages->pageSize;
+    }
+    return (memoryRequirement/pages->pageSize) + 1;
+}
+
+/* mark the count lowest free frames as allocated into frames; there must be that many free.
+    full words are skipped through the summary bitmap, so the cost follows the number of frames taken
+*/
+void takeFrames(FrameTable* pages, int pagesRequired, int* frames) {
+    /* groups before searchFrom are known to be full */
+    int taken = 0;
+    for (int group = pages->searchFrom; taken < pagesRequired; group++) {
+        /* words in this group of 64 that still have a free frame */
+        uint64_t open = ~pages->full[group];
+        while (open != 0 && taken < pagesRequired) {
+            int word = group * 64 + __builtin_ctzll(open);
+            uint64_t free = ~pages->frames[word];
+
+            /* a word with no more free frames than are still needed gets used up */
+            if (__builtin_popcountll(free) <= pagesRequired - taken) {
+                pages->full[group] |= (uint64_t)1 << (word % 64);
+            }
+
+            /* mark the frames used by the process, lowest first */
+            while (free != 0 && taken < pagesRequired) {
+                frames[taken++] = word * 64 + __builtin_ctzll(free);
+                free &= free - 1;
+            }
+            pages->frames[word] = ~free;
+            open &= open - 1;
+        }
+        if (~pages->full[group] == 0 && pages->searchFrom == group) {
+            pages->searchFrom = group + 1;
+        }
+    }
+    pages->allocated += pagesRequired;
+}
+
+/* Allocation of paged memory;
+    memory is treated as a bitmap of frameCount frames of pageSize KB, packed 64 frames to a word,
+    where 0 indicates a free frame and 1 indicates an allocated frame
+*/
+FrameTable* createFrameTable(Arena* arena, int frameCount, int pageSize) {
+    FrameTable* pages = (FrameTable*)arenaAlloc(arena, sizeof(FrameTable));
+    pages->arena = arena;
+    pages->frameCount = frameCount;
+    pages->wordCount = (frameCount + 63) / 64;
+    pages->allocated = 0;
+    pages->pageSize = pageSize;
+    pages->searchFrom = 0;
+    pages->replacement = REPLACEMENT_PROCESS;
+    pages->workingSet = 0;
+    pages->frames = (uint64_t*)arenaAlloc(arena, sizeof(uint64_t) * pages->wordCount);
+    pages->full = (uint64_t*)arenaAlloc(arena, sizeof(uint64_t) * ((pages->wordCount + 63) / 64));
+
+    /* frames past the end of memory are permanently marked as allocated, 
+        as are the words past the end of the table */
+    if (frameCount % 64 != 0) {
+        pages->frames[pages->wordCount - 1] = ~(uint64_t)0 << (frameCount % 64);
+    }
+    if (pages->wordCount % 64 != 0) {
+        pages->full[pages->wordCount / 64] = ~(uint64_t)0 << (pages->wordCount % 64);
+    }
+    return pages;
+}
+
+/* keep the per-frame state replacing single pages needs; whole processes need none */
+void enablePageReplacement(FrameTable* pages, int replacement) {
+    pages->replacement = replacement;
+    if (replacement == REPLACEMENT_PROCESS) {
+        return;
+    }
+    pages->owner = (Process**)arenaAlloc(pages->arena, sizeof(Process*) * pages->frameCount);
+    pages->page = (int*)arenaAlloc(pages->arena, sizeof(int) * pages->frameCount);
+    pages->scratch = (int*)arenaAlloc(pages->arena, sizeof(int) * pages->frameCount);
+    if (replacement == REPLACEMENT_FIFO) {
+        pages->older = (int*)arenaAlloc(pages->arena, sizeof(int) * pages->frameCount);
+        pages->newer = (int*)arenaAlloc(pages->arena, sizeof(int) * pages->frameCount);
+        pages->oldest = pages->newest = NOT_ALLOCATED;
+    } else if (replacement == REPLACEMENT_CLOCK) {
+        pages->cleared = (long long*)arenaAlloc(pages->arena, sizeof(long long) * pages->frameCount);
+        pages->hand = 0;
+    }
+}
+
+/* the --replacement policy, whole processes when none was given */
+int replacementPolicy(const char* name) {
+    if (name[0] == '\0') {
+        return REPLACEMENT_PROCESS;
+    } else if (strcmp(name, REPLACE_LRU) == 0) {
+        return REPLACEMENT_LRU;
+    } else if (strcmp(name, REPLACE_FIFO) == 0) {
+        return REPLACEMENT_FIFO;
+    } else if (strcmp(name, REPLACE_CLOCK) == 0) {
+        return REPLACEMENT_CLOCK;
+    } else if (strcmp(name, REPLACE_OPT) == 0) {
+        return REPLACEMENT_OPT;
+    }
+    fprintf(stderr, "Unknown page replacement policy: %s\n", name);
+    exit(EXIT_FAILURE);
+}
+
+/*******************************************************************************************************/
+/* Free Extent Tree Functions
+
+    Treap of free runs ordered by start address. Every node caches the largest run in its subtree,
+    so first-fit is a single root-to-node descent and coalescing a freed block only needs
+    its neighbours on either side of the split point
+*/
+FreeExtentTree* createFreeExtentTree(Arena* arena, long long capacity) {
+    FreeExtentTree* tree = (FreeExtentTree*)arenaAlloc(arena, sizeof(FreeExtentTree));
+    tree->arena = arena;
+    tree->nodes = NULL;
+    tree->nodeCount = tree->nodeCapacity = 0;
+    tree->freeNode = NOT_ALLOCATED;
+    tree->holes = 0;
+    tree->capacity = capacity;
+    tree->allocated = 0;
+    tree->seed = 2463534242u;
+
+    /* all of memory starts as one free run */
+    tree->root = newFreeExtent(tree, 0, capacity);
+    return tree;
+}
+
+/* take a node from the pool, growing it if every node is in use */
+int newFreeExtent(FreeExtentTree* tree, long long start, long long length) {
+    int node = tree->freeNode;
+    if (node != NOT_ALLOCATED) {
+        tree->freeNode = tree->nodes[node].left;
+    } else {
+        if (tree->nodeCount == tree->nodeCapacity) {
+            int capacity = (tree->nodeCapacity == 0) ? INITIAL_PROCESSES : tree->nodeCapacity * 2;
+            tree->nodes = arenaGrow(tree->arena, tree->nodes, sizeof(FreeExtent) * tree->nodeCapacity, 
+                                    sizeof(FreeExtent) * capacity);
+            tree->nodeCapacity = capacity;
+        }
+        node = tree->nodeCount++;
+    }
+
+    /* xorshift priorities keep the treap balanced in expectation and the run reproducible */
+    tree->seed ^= tree->seed << 13;
+    tree->seed ^= tree->seed >> 17;
+    tree->seed ^= tree->seed << 5;
+
+    tree->holes++;
+    FreeExtent* extent = &tree->nodes[node];
+    extent->start = start;
+    extent->length = extent->largest = length;
+    extent->priority = tree->seed;
+    extent->left = extent->right = NOT_ALLOCATED;
+    return node;
+}
+
+void releaseFreeExtent(FreeExtentTree* tree, int node) {
+    tree->nodes[node].left = tree->freeNode;
+    tree->freeNode = node;
+    tree->holes--;
+}
+
+/* recompute the largest free run below a node after its children changed */
+void updateFreeExtent(FreeExtentTree* tree, int node) {
+    FreeExtent* extent = &tree->nodes[node];
+    extent->largest = extent->length;
+    if (extent->left != NOT_ALLOCATED && tree->nodes[extent->left].largest > extent->largest) {
+        extent->largest = tree->nodes[extent->left].largest;
+    }
+    if (extent->right != NOT_ALLOCATED && tree->nodes[extent->right].largest > extent->largest) {
+        extent->largest = tree->nodes[extent->right].largest;
+    }
+}
+
+/* join two treaps where every run in left lies below every run in right */
+int mergeFreeExtents(FreeExtentTree* tree, int left, int right) {
+    if (left == NOT_ALLOCATED) {
+        return right;
+    }
+    if (right == NOT_ALLOCATED) {
+        return left;
+    }
+    if (tree->nodes[left].priority > tree->nodes[right].priority) {
+        tree->nodes[left].right = mergeFreeExtents(tree, tree->nodes[left].right, right);
+        updateFreeExtent(tree, left);
+        return left;
+    }
+    tree->nodes[right].left = mergeFreeExtents(tree, left, tree->nodes[right].left);
+    updateFreeExtent(tree, right);
+    return right;
+}
+
+/* split a treap into the runs starting below start and the runs starting at or above it */
+void splitFreeExtents(FreeExtentTree* tree, int node, long long start, int* left, int* right) {
+    if (node == NOT_ALLOCATED) {
+        *left = *right = NOT_ALLOCATED;
+        return;
+    }
+    if (tree->nodes[node].start < start) {
+        splitFreeExtents(tree, tree->nodes[node].right, start, &tree->nodes[node].right, right);
+        *left = node;
+    } else {
+        splitFreeExtents(tree, tree->nodes[node].left, start, left, &tree->nodes[node].left);
+        *right = node;
+    }
+    updateFreeExtent(tree, node);
+}
+
+/* carve length KB off the front of the lowest addressed run that fits,
+    returning the new subtree root since an exhausted run is removed */
+int takeFirstFit(FreeExtentTree* tree, int node, long long length, long long* start) {
+    FreeExtent* extent = &tree->nodes[node];
+    if (extent->left != NOT_ALLOCATED && tree->nodes[extent->left].largest >= length) {
+        extent->left = takeFirstFit(tree, extent->left, length, start);
+    } else if (extent->length >= length) {
+        *start = extent->start;
+        extent->start += length;
+        extent->length -= length;
+        if (extent->length == 0) {
+            int merged = mergeFreeExtents(tree, extent->left, extent->right);
+            releaseFreeExtent(tree, node);
+            return merged;
+        }
+    } else {
+        extent->right = takeFirstFit(tree, extent->right, length, start);
+    }
+    updateFreeExtent(tree, node);
+    return node;
+}
+
+/* detach the highest (fromRight) or lowest addressed run of a treap into popped */
+int popFreeExtent(FreeExtentTree* tree, int node, int fromRight, int* popped) {
+    FreeExtent* extent = &tree->nodes[node];
+    int child = fromRight ? extent->right : extent->left;
+    if (child == NOT_ALLOCATED) {
+        *popped = node;
+        int rest = fromRight ? extent->left : extent->right;
+        extent->left = extent->right = NOT_ALLOCATED;
+        updateFreeExtent(tree, node);
+        return rest;
+    }
+    child = popFreeExtent(tree, child, fromRight, popped);
+    if (fromRight) {
+        tree->nodes[node].right = child;
+    } else {
+        tree->nodes[node].left = child;
+    }
+    updateFreeExtent(tree, node);
+    return node;
+}
+
+/* once every block has slid down, all free memory is one run at the top; every node goes back to the pool */
+void compactFreeExtents(FreeExtentTree* tree) {
+    tree->nodeCount = 0;
+    tree->freeNode = NOT_ALLOCATED;
+    tree->holes = 0;
+    tree->root = NOT_ALLOCATED;
+    if (tree->allocated < tree->capacity) {
+        tree->root = newFreeExtent(tree, tree->allocated, tree->capacity - tree->allocated);
+    }
+}
+
+/*******************************************************************************************************/
+/* Arena Functions
+
+    A run allocates its structures from one arena instead of the heap, so nothing is freed piecemeal
+    and the whole run is released by a single reset. Growing buffers move to a larger block and leave
+    the old one behind, which at most doubles what they use. Frame lists are the exception that comes
+    and goes with every process, so they are recycled by size class rather than carved afresh
+*/
+/* a zeroed block of size bytes, in a new chunk when the newest one can't hold it */
+void* arenaAlloc(Arena* arena, size_t size) {
+    size_t header = (sizeof(ArenaChunk) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    ArenaChunk* chunk = arena->chunks;
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        size_t chunkSize = (header + size > ARENA_CHUNK_SIZE) ? header + size : ARENA_CHUNK_SIZE;
+        chunk = (ArenaChunk*)calloc(1, chunkSize);
+        if (chunk == NULL) {
+            fprintf(stderr, "Malloc failure: Arena Chunk Not Initialized\n");
+            exit(EXIT_FAILURE);
+        }
+        chunk->size = chunkSize;
+        chunk->used = header;
+
+        /* a chunk made for one large block goes behind the newest, which may still have room */
+        if (arena->chunks != NULL && chunkSize > ARENA_CHUNK_SIZE) {
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+        } else {
+            chunk->next = arena->chunks;
+            arena->chunks = chunk;
+        }
+    }
+    void* block = (char*)chunk + chunk->used;
+    chunk->used += size;
+    return block;
+}
+
+/* a larger copy of a growing buffer, for buffers that would otherwise be reallocated */
+void* arenaGrow(Arena* arena, void* block, size_t size, size_t newSize) {
+    void* grown = arenaAlloc(arena, newSize);
+    if (size > 0) {
+        memcpy(grown, block, size);
+    }
+    return grown;
+}
+
+/* the size class of a frame list: the power of two it is rounded up to, big enough to chain */
+int frameListClass(int frameCount) {
+    int class = 1;
+    while (class < FRAME_LIST_CLASSES - 1 && (1LL << class) < frameCount) {
+        class++;
+    }
+    return class;
+}
+
+/* a frame list for frameCount frames, reusing one a FINISHED process gave back when there is one */
+int* takeFrameList(Arena* arena, int frameCount) {
+    int class = frameListClass(frameCount);
+    int* frames = arena->frameLists[class];
+    if (frames != NULL) {
+        arena->frameLists[class] = *(int**)frames;
+        return frames;
+    }
+    return (int*)arenaAlloc(arena, sizeof(int) << class);
+}
+
+/* keep a FINISHED process's frame list for the next process of its size class */
+void giveFrameList(Arena* arena, int* frames, int frameCount) {
+    int class = frameListClass(frameCount);
+    *(int**)frames = arena->frameLists[class];
+    arena->frameLists[class] = frames;
+}
+
+/* release everything the run allocated */
+void resetArena(Arena* arena) {
+    while (arena->chunks != NULL) {
+        ArenaChunk* next = arena->chunks->next;
+        free(arena->chunks);
+        arena->chunks = next;
+    }
+    for (int class = 0; class < FRAME_LIST_CLASSES; class++) {
+        arena->frameLists[class] = NULL;
+    }
+}
+
+/*******************************************************************************************************/
+/* Buddy Allocator Functions
+
+    A request is rounded up to a block of 2^order KB, taken from the smallest order with a free block
+    and split in halves down to its size, each upper half becoming free at the order below.
+    A freed block merges with its buddy, the block its address differs from in bit order alone,
+    for as long as that buddy is free at the same order, so both allocate and free are O(orders)
+*/
+BuddyAllocator* createBuddyAllocator(Arena* arena, long long capacity) {
+    BuddyAllocator* buddy = (BuddyAllocator*)arenaAlloc(arena, sizeof(BuddyAllocator));
+    buddy->arena = arena;
+    buddy->blocks = NULL;
+    buddy->blockCount = buddy->blockCapacity = 0;
+    buddy->freeBlock = NOT_ALLOCATED;
+    for (int order = 0; order < BUDDY_ORDERS; order++) {
+        buddy->heads[order] = NOT_ALLOCATED;
+    }
+    buddy->index = NULL;
+    buddy->indexCapacity = 0;
+    buddy->holes = 0;
+    buddy->capacity = capacity;
+    buddy->allocated = 0;
+
+    /* memory starts as the largest aligned blocks that fit, from the lowest address up */
+    long long start = 0;
+    for (int order = BUDDY_ORDERS - 1; order >= 0; order--) {
+        if (capacity - start >= (1LL << order)) {
+            addBuddyBlock(buddy, start, order);
+            start += 1LL << order;
+        }
+    }
+    return buddy;
+}
+
+/* the smallest order whose blocks hold memoryRequirement KB */
+int buddyOrder(long long memoryRequirement) {
+    int order = 0;
+    while (order < BUDDY_ORDERS - 1 && (1LL << order) < memoryRequirement) {
+        order++;
+    }
+    return order;
+}
+
+/* the start of a block for the request, split off the smallest free block that holds it */
+long long allocateBuddyBlock(BuddyAllocator* buddy, long long memoryRequirement) {
+    int order = buddyOrder(memoryRequirement);
+    int from = order;
+    while (from < BUDDY_ORDERS && buddy->heads[from] == NOT_ALLOCATED) {
+        from++;
+    }
+    if (from == BUDDY_ORDERS) {
+        return NOT_ALLOCATED;
+    }
+
+    int block = buddy->heads[from];
+    long long start = buddy->blocks[block].start;
+    removeBuddyBlock(buddy, block);
+
+    /* keep the lower half, freeing the upper half at each order on the way down */
+    while (from > order) {
+        from--;
+        addBuddyBlock(buddy, start + (1LL << from), from);
+    }
+    buddy->allocated += 1LL << order;
+    return start;
+}
+
+/* free a process's block, merging it with its buddy at each order while the buddy is free */
+void deallocateBuddyBlock(BuddyAllocator* buddy, long long start, long long memoryRequirement) {
+    int order = buddyOrder(memoryRequirement);
+    buddy->allocated -= 1LL << order;
+
+    while (order < BUDDY_ORDERS - 1) {
+        int neighbour = findBuddyBlock(buddy, start ^ (1LL << order));
+        if (neighbour == NOT_ALLOCATED || buddy->blocks[neighbour].order != order) {
+            break;
+        }
+        removeBuddyBlock(buddy, neighbour);
+        start &= ~(1LL << order);
+        order++;
+    }
+    addBuddyBlock(buddy, start, order);
+}
+
+/* the size of the largest free block */
+long long largestBuddyBlock(BuddyAllocator* buddy) {
+    for (int order = BUDDY_ORDERS - 1; order >= 0; order--) {
+        if (buddy->heads[order] != NOT_ALLOCATED) {
+            return 1LL << order;
+        }
+    }
+    return 0;
+}
+
+/* put a free block at the head of its order's list and into the index */
+void addBuddyBlock(BuddyAllocator* buddy, long long start, int order) {
+    int block = buddy->freeBlock;
+    if (block != NOT_ALLOCATED) {
+        buddy->freeBlock = buddy->blocks[block].next;
+    } else {
+        if (buddy->blockCount == buddy->blockCapacity) {
+            int capacity = (buddy->blockCapacity == 0) ? INITIAL_PROCESSES : buddy->blockCapacity * 2;
+            buddy->blocks = arenaGrow(buddy->arena, buddy->blocks, sizeof(BuddyBlock) * buddy->blockCapacity, 
+                                      sizeof(BuddyBlock) * capacity);
+            buddy->blockCapacity = capacity;
+        }
+        block = buddy->blockCount++;
+    }
+
+    BuddyBlock* entry = &buddy->blocks[block];
+    entry->start = start;
+    entry->order = order;
+    entry->prev = NOT_ALLOCATED;
+    entry->next = buddy->heads[order];
+    if (entry->next != NOT_ALLOCATED) {
+        buddy->blocks[entry->next].prev = block;
+    }
+    buddy->heads[order] = block;
+
+    /* the index is kept at most half full so probes stay short */
+    buddy->holes++;
+    if (buddy->holes * 2 > buddy->indexCapacity) {
+        growBuddyIndex(buddy);
+    }
+    buddy->index[buddySlot(buddy, start)] = block;
+}
+
+/* take a free block off its order's list and out of the index */
+void removeBuddyBlock(BuddyAllocator* buddy, int block) {
+    BuddyBlock* entry = &buddy->blocks[block];
+    if (entry->prev != NOT_ALLOCATED) {
+        buddy->blocks[entry->prev].next = entry->next;
+    } else {
+        buddy->heads[entry->order] = entry->next;
+    }
+    if (entry->next != NOT_ALLOCATED) {
+        buddy->blocks[entry->next].prev = entry->prev;
+    }
+
+    /* shift later entries of the probe sequence back into the emptied slot,
+        so a lookup never stops early at a gap */
+    int mask = buddy->indexCapacity - 1;
+    int empty = buddySlot(buddy, entry->start);
+    int next = empty;
+    while (TRUE) {
+        next = (next + 1) & mask;
+        int moved = buddy->index[next];
+        if (moved == NOT_ALLOCATED) {
+            break;
+        }
+
+        /* an entry whose home slot lies after the gap, up to its own slot, must stay where it is */
+        int home = buddyHash(buddy, buddy->blocks[moved].start);
+        if ((empty <= next) ? (empty < home && home <= next) : (empty < home || home <= next)) {
+            continue;
+        }
+        buddy->index[empty] = moved;
+        empty = next;
+    }
+    buddy->index[empty] = NOT_ALLOCATED;
+
+    entry->next = buddy->freeBlock;
+    buddy->freeBlock = block;
+    buddy->holes--;
+}
+
+/* the free block starting at start, if there is one */
+int findBuddyBlock(BuddyAllocator* buddy, long long start) {
+    return buddy->index[buddySlot(buddy, start)];
+}
+
+/* the first index slot probed for the block at start */
+int buddyHash(BuddyAllocator* buddy, long long start) {
+    return (int)(((uint64_t)start * 0x9E3779B97F4A7C15ull) >> 32) & (buddy->indexCapacity - 1);
+}
+
+/* the index slot holding the free block at start, or the empty slot where it would go */
+int buddySlot(BuddyAllocator* buddy, long long start) {
+    int mask = buddy->indexCapacity - 1;
+    int slot = buddyHash(buddy, start);
+    while (buddy->index[slot] != NOT_ALLOCATED && buddy->blocks[buddy->index[slot]].start != start) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/* double the index and reinsert every free block */
+void growBuddyIndex(BuddyAllocator* buddy) {
+    buddy->indexCapacity = (buddy->indexCapacity == 0) ? INITIAL_PROCESSES : buddy->indexCapacity * 2;
+    buddy->index = (int*)arenaAlloc(buddy->arena, sizeof(int) * buddy->indexCapacity);
+    for (int slot = 0; slot < buddy->indexCapacity; slot++) {
+        buddy->index[slot] = NOT_ALLOCATED;
+    }
+    for (int order = 0; order < BUDDY_ORDERS; order++) {
+        for (int block = buddy->heads[order]; block != NOT_ALLOCATED; block = buddy->blocks[block].next) {
+            buddy->index[buddySlot(buddy, buddy->blocks[block].start)] = block;
+        }
+    }
+}
+
+/*******************************************************************************************************/
+
+/* standard update function. Runs the CPU process for ONE quantum,
+    or for as many quanta as it can run uninterrupted before the horizon or the scheduler's next decision
+*/
+int update(Process* CPUproc, int quantum, long long* time, long long* finished, Scheduler* scheduler, int* isNew,
+           long long horizon) {
+    /* check whether the current CPU process has just entered, 
+        or if it was already running */
+    if (CPUproc->state == READY) {
+        CPUproc->state = RUNNING;
+        /* mark the process as NEW as up to this point, 
+            the current CPU process was only considered a candidate */
+        *isNew = TRUE;
+    }
+
+    /* check if quantum has elapsed for RUNNING process, 
+        since process switching and completion can ONLY be performed at the end of a quantum.
+        isNew indiciates whether a process has already run for a quantum or not */
+    if ((CPUproc->state == RUNNING) && (!(*isNew))) {
+        /* if at the end of a quantum, a processes CPUtime has passed its serviceTime,
+            it is FINISHED */
+        if (CPUproc->remainingTime <= 0) {
+            CPUproc->state = FINISHED;
+            (*finished)++;
+            return FINISHED;
+        } 
+ 
+        /* if a process has already run for a quantum and the scheduling policy prefers a READY process,
+            the process must be SWITCHed out */
+        else if (shouldPreempt(scheduler, CPUproc, *time)) { 
+            return SWITCH;
+        } 
+    }
+
+    /* run the process for ONE quantum. 
+        this will run ONLY if the process isNew
+        or if there are no other processes in the queue */
+    if ((CPUproc->state == RUNNING)) {
+        long long slice = quantum;
+
+        /* a process the policy won't preempt can only be interrupted by its own completion,
+            the next arrival or the policy's next decision, so jump straight to whichever quantum boundary comes first */
+        if (!(*isNew)) {
+            long long quantaLeft = (CPUproc->remainingTime + quantum - 1) / quantum;
+            slice = quantaLeft * quantum;
+            if (horizon != NO_EVENT && horizon - *time < slice) {
+                slice = horizon - *time;
+            }
+            long long limit = runLimit(scheduler, CPUproc, *time);
+            if (limit != NO_EVENT) {
+                long long limitQuanta = (limit > quantum) ? (limit + quantum - 1) / quantum : 1;
+                if (limitQuanta * quantum < slice) {
+                    slice = limitQuanta * quantum;
+                }
+            }
+        }
+
+        /* take the slice off the remaining service time and add it to totalTime */
+        CPUproc->remainingTime -= slice;
+        chargeRun(scheduler, CPUproc, slice);
+        (*time) += slice;  
+    }
+
+    return CONTINUE;
+} 
+
+/* Find the quantum boundary at which the next process will be admitted,
+    or NO_EVENT if every process has already arrived
+*/
+long long nextArrivalBoundary(Workload* workload, int quantum) {
+    if (!pendingArrivals(workload)) {
+        return NO_EVENT;
+    }
+
+    long long nextArrival = workload->streaming ? workload->columns.arrivalTime[workload->next->id] 
+                                                : workload->columns.arrivalTime[workload->admitted];
+    return admissionBoundary(nextArrival, quantum);
+}
+
+/* Check for READY processes according to arrival time;
+    processes are sorted by arrival, so admitted is a cursor to the first one yet to arrive
+*/
+void checkProcesses(Simulation* simulation, long long time) {
+    Workload* workload = simulation->workload;
+
+    /* enque every process that has arrived by the current time, in file order within the quantum */
+    if (workload->streaming) {
+        while (workload->next != NULL && workload->columns.arrivalTime[workload->next->id] <= time) {
+            admitProcess(simulation, workload->next, time);
+            readNextRecord(workload);
+        }
+        return;
+    }
+    while (workload->admitted < workload->processCount && 
+           workload->columns.arrivalTime[workload->admitted] <= time) {
+        admitProcess(simulation, &workload->processes[workload->admitted], time);
+        workload->admitted++;
+    }
+}  
+
+/* an arrival joins the run queue of the core holding the fewest processes, the lowest core on ties */
+void admitProcess(Simulation* simulation, Process* process, long long time) {
+    Core* target = &simulation->cores[0];
+    int load = scheduledProcesses(target->scheduler);
+    for (int i = 1; i < simulation->coreCount && load > 0; i++) {
+        int coreLoad = scheduledProcesses(simulation->cores[i].scheduler);
+        if (coreLoad < load) {
+            target = &simulation->cores[i];
+            load = coreLoad;
+        }
+    }
+    makeReady(target->scheduler, process, time);
+    wakeCore(target, time);
+    simulation->remaining++;
+}
+
+/* whether any process is still to arrive */
+int pendingArrivals(Workload* workload) {
+    return workload->streaming ? workload->next != NULL : workload->admitted < workload->processCount;
+}
+
+/* record a FINISHED process's completion; a streamed process is added to the totals
+    and its slot handed back to the pool
+*/
+void retireProcess(Workload* workload, Process* process, long long time) {
+    ProcessColumns* columns = &workload->columns;
+    columns->completionTime[process->id] = time;
+    if (workload->streaming) {
+        addStatistics(&workload->totals, columns->arrivalTime[process->id], columns->serviceTime[process->id], time);
+        process->lruNext = workload->freeSlots;
+        workload->freeSlots = process;
+    }
+}
+
+/*******************************************************************************************************/
+// Output Functions
+/* hand the buffered log to the kernel, retrying short and interrupted writes
+*/
+void flushLog(LogWriter* writer) {
+    size_t written = 0;
+    while (written < writer->length) {
+        ssize_t result = write(writer->fd, writer->buffer + written, writer->length - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("write");
+            exit(EXIT_FAILURE);
+        }
+        written += result;
+    }
+    writer->length = 0;
+}
+
+void logString(LogWriter* writer, const char* string) {
+    for (; *string != '\0'; string++) {
+        if (writer->length == LOG_BUFFER_SIZE) {
+            flushLog(writer);
+        }
+        writer->buffer[writer->length++] = *string;
+    }
+}
+
+void logBytes(LogWriter* writer, const char* bytes, size_t length) {
+    while (length > 0) {
+        if (writer->length == LOG_BUFFER_SIZE) {
+            flushLog(writer);
+        }
+        size_t chunk = LOG_BUFFER_SIZE - writer->length;
+        if (chunk > length) {
+            chunk = length;
+        }
+        memcpy(writer->buffer + writer->length, bytes, chunk);
+        writer->length += chunk;
+        bytes += chunk;
+        length -= chunk;
+    }
+}
+
+/* write an integer in decimal without going through printf
+*/
+void logInt(LogWriter* writer, long long value) {
+    char digits[24];
+    int count = 0;
+    unsigned long long magnitude = (value < 0) ? -(unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[count++] = '0' + (magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        digits[count++] = '-';
+    }
+
+    if (writer->length + count > LOG_BUFFER_SIZE) {
+        flushLog(writer);
+    }
+    while (count > 0) {
+        writer->buffer[writer->length++] = digits[--count];
+    }
+}
+
+/* write a list of frame numbers as [a,b,c],
+    or with consecutive frames collapsed into ranges as [a-c] when frameRanges is set
+*/
+void logFrames(LogWriter* writer, int* frames, int frameCount) {
+    logString(writer, "[");
+    for (int i = 0; i < frameCount; i++) {
+        if (i > 0) {
+            logString(writer, ",");
+        }
+        logInt(writer, frames[i]);
+
+        if (writer->frameRanges) {
+            int last = i;
+            while (last + 1 < frameCount && frames[last + 1] == frames[last] + 1) {
+                last++;
+            }
+            if (last > i) {
+                logString(writer, "-");
+                logInt(writer, frames[last]);
+                i = last;
+            }
+        }
+    }
+    logString(writer, "]");
+}
+
+/* the part of a RUNNING line shared by every memory strategy, without the newline
+*/
+void logRunning(LogWriter* writer, long long time, const char* processName, long long remainingTime) {
+    logInt(writer, time);
+    logString(writer, ",RUNNING,process-name=");
+    logString(writer, processName);
+    logString(writer, ",remaining-time=");
+    logInt(writer, remainingTime);
+}
+
+void logEvicted(LogWriter* writer, long long time, int* frames, int frameCount, int core) {
+    if (!writer->events) {
+        return;
+    }
+    logInt(writer, time);
+    logString(writer, ",EVICTED,evicted-frames=");
+    logFrames(writer, frames, frameCount);
+    logEventEnd(writer, core);
+}
+
+void logCompacted(LogWriter* writer, long long time, long long moved, long long cost, int core) {
+    if (!writer->events) {
+        return;
+    }
+    logInt(writer, time);
+    logString(writer, ",COMPACTED,moved-kb=");
+    logInt(writer, moved);
+    logString(writer, ",compaction-time=");
+    logInt(writer, cost);
+    logEventEnd(writer, core);
+}
+
+void logFinished(LogWriter* writer, long long time, const char* processName, int remaining, int core) {
+    if (!writer->events) {
+        return;
+    }
+    logInt(writer, time);
+    logString(writer, ",FINISHED,process-name=");
+    logString(writer, processName);
+    logString(writer, ",proc-remaining=");
+    logInt(writer, remaining);
+    logEventEnd(writer, core);
+}
+
+/* end an event line, tagged with the core it happened on unless core is NO_CORE */
+void logEventEnd(LogWriter* writer, int core) {
+    if (core != NO_CORE) {
+        logString(writer, ",core=");
+        logInt(writer, core);
+    }
+    logString(writer, "\n");
+}
+
+/* the current fragmentation and eviction totals as extra fields of a RUNNING line */
+void logMemoryMetrics(LogWriter* writer, MemoryMetrics* metrics) {
+    if (metrics->strategy == MEMORY_FIRST_FIT || metrics->strategy == MEMORY_BUDDY) {
+        char external[64];
+        snprintf(external, sizeof(external), "%.2f", metrics->external);
+        logString(writer, ",holes=");
+        logInt(writer, metrics->holes);
+        logString(writer, ",largest-hole=");
+        logInt(writer, metrics->largestHole);
+        logString(writer, ",external-fragmentation=");
+        logString(writer, external);
+    }
+    if (metrics->strategy == MEMORY_PAGED || metrics->strategy == MEMORY_BUDDY) {
+        logString(writer, ",internal-fragmentation=");
+        logInt(writer, metrics->internal);
+    }
+    if (metrics->strategy == MEMORY_PAGED) {
+        logString(writer, ",evictions=");
+        logInt(writer, metrics->evictions);
+        logString(writer, ",evicted-frames=");
+        logInt(writer, metrics->evictedFrames);
+        logString(writer, ",page-faults=");
+        logInt(writer, metrics->pageFaults);
+    }
+    if (metrics->compaction) {
+        logString(writer, ",compactions=");
+        logInt(writer, metrics->compactions);
+        logString(writer, ",compacted-kb=");
+        logInt(writer, metrics->compactedKB);
+    }
+}
+
+/*******************************************************************************************************/
+// Basic pre-task HELPER FUNCTIONS
+/* read command line arguments to deterimine:
+    list of processes, memory strategy, & quantum length
+*/
+void readInput(int argc, char* argv[], Config* config){
+    for (int i = 1; i < argc; i++) {
+        /* filename */
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            addInputPath(config, argv[++i]);
+        /* memory strategy (infinite, first-fit, paged, virtual)*/
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            snprintf(config->memoryStrategy, MAX_FILENAME_STRATEGY_LEN, "%s", argv[++i]);
+        /* number of simulated cores */
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            config->cores = atoi(argv[++i]);
+        /* scheduling policy (rr, sjf, srtf, priority, mlfq) */
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            snprintf(config->policy, MAX_FILENAME_STRATEGY_LEN, "%s", argv[++i]);
+        /* quantum length (1, 2, 3)*/
+        } else if (strcmp(argv[i], "-q") == 0 && i + 1 < argc) {
+            config->quantum = atoi(argv[++i]);
+        /* total memory in KB */
+        } else if (strcmp(argv[i], "--memory") == 0 && i + 1 < argc) {
+            config->memoryCapacity = atoll(argv[++i]);
+        /* size of a page and frame in KB */
+        } else if (strcmp(argv[i], "--page-size") == 0 && i + 1 < argc) {
+            config->pageSize = atoi(argv[++i]);
+        /* comma separated quanta and memory strategies to sweep over */
+        } else if (strcmp(argv[i], "--sweep-quanta") == 0 && i + 1 < argc) {
+            snprintf(config->sweepQuanta, MAX_FILENAME_STRATEGY_LEN, "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--sweep-strategies") == 0 && i + 1 < argc) {
+            snprintf(config->sweepStrategies, MAX_FILENAME_STRATEGY_LEN, "%s", argv[++i]);
+        /* number of threads a sweep runs on */
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config->threads = atoi(argv[++i]);
+        /* print frame lists as ranges of consecutive frames */
+        } else if (strcmp(argv[i], "--frame-ranges") == 0) {
+            config->frameRanges = TRUE;
+        /* skip the event log and only print the statistics */
+        } else if (strcmp(argv[i], "--summary-only") == 0) {
+            config->events = FALSE;
+        /* read processes as they arrive instead of loading the whole file */
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            config->stream = TRUE;
+        /* write each batch run's log to its own file in this directory */
+        } else if (strcmp(argv[i], "--output-dir") == 0 && i + 1 < argc) {
+            snprintf(config->outputDir, MAX_PATH_LEN, "%s", argv[++i]);
+        /* report turnaround, waiting, response and preemption percentiles */
+        } else if (strcmp(argv[i], "--latency") == 0) {
+            config->latency = TRUE;
+        /* write one CSV record of those latencies per process to a file */
+        } else if (strcmp(argv[i], "--latency-csv") == 0 && i + 1 < argc) {
+            snprintf(config->latencyCsv, MAX_PATH_LEN, "%s", argv[++i]);
+        /* replace single pages by lru, fifo, clock or opt instead of whole processes */
+        } else if (strcmp(argv[i], "--replacement") == 0 && i + 1 < argc) {
+            snprintf(config->replacement, MAX_FILENAME_STRATEGY_LEN, "%s", argv[++i]);
+        /* compact first-fit memory when no hole fits, charging this much time per KB moved */
+        } else if (strcmp(argv[i], "--compact") == 0 && i + 1 < argc) {
+            config->compactCost = atof(argv[++i]);
+            if (config->compactCost < 0) {
+                fprintf(stderr, "--compact needs a cost per KB of at least 0\n");
+                exit(EXIT_FAILURE);
+            }
+        /* add fragmentation and eviction fields to RUNNING lines and the statistics */
+        } else if (strcmp(argv[i], "--memory-stats") == 0) {
+            config->memoryStats = TRUE;
+        /* report events simulated, wall time and peak memory on stderr */
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            config->bench = TRUE;
+        }
+    }
+
+    /* arrivals are admitted at multiples of the quantum; a sweep over quanta needs no -q */
+    char list[MAX_FILENAME_STRATEGY_LEN], *saved, *value;
+    int sweptQuanta = 0;
+    snprintf(list, sizeof(list), "%s", config->sweepQuanta);
+    for (value = strtok_r(list, ",", &saved); value != NULL; value = strtok_r(NULL, ",", &saved)) {
+        if (atoi(value) < 1) {
+            fprintf(stderr, "Invalid quantum in --sweep-quanta: %s, must be at least 1\n", value);
+            exit(EXIT_FAILURE);
+        }
+        sweptQuanta++;
+    }
+    if (sweptQuanta == 0 && config->quantum < 1) {
+        fprintf(stderr, "Invalid quantum: %d, must be at least 1\n", config->quantum);
+        exit(EXIT_FAILURE);
+    }
+
+    /* more than one file, or a directory, is a batch of runs */
+    if (config->fileCount > 1) {
+        config->batch = TRUE;
+    } else if (config->fileCount == 1) {
+        snprintf(config->filename, MAX_PATH_LEN, "%s", config->files[0]);
+    }
+    if (config->batch && (config->sweepQuanta[0] != '\0' || config->sweepStrategies[0] != '\0')) {
+        fprintf(stderr, "A batch of files can't be combined with a sweep\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* per-process records are written for a single run only */
+    if (config->latencyCsv[0] != '\0' && 
+            (config->batch || config->sweepQuanta[0] != '\0' || config->sweepStrategies[0] != '\0')) {
+        fprintf(stderr, "--latency-csv can't be combined with a batch or a sweep\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* opt looks ahead through the whole workload */
+    if (config->stream && strcmp(config->replacement, REPLACE_OPT) == 0) {
+        fprintf(stderr, "--replacement opt can't be combined with --stream\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* a sweep replays the same workload many times, so it needs the whole table */
+    if (config->stream && (config->sweepQuanta[0] != '\0' || config->sweepStrategies[0] != '\0')) {
+        fprintf(stderr, "--stream can't be combined with a sweep\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* each file is simulated once, and no two runs may write the same output file */
+    if (config->batch) {
+        removeDuplicateInputs(config);
+        if (config->outputDir[0] != '\0') {
+            checkOutputPaths(config);
+        }
+    }
+
+    if (config->cores < 1 || config->cores > MAX_CORES) {
+        fprintf(stderr, "Invalid number of cores: %d, must be 1 to %d\n", config->cores, MAX_CORES);
+        exit(EXIT_FAILURE);
+    }
+
+    /* frame numbers are stored as int, which bounds the number of frames */
+    if (config->memoryCapacity <= 0 || config->pageSize <= 0 || 
+            config->memoryCapacity / config->pageSize > INT_MAX) {
+        fprintf(stderr, "Invalid memory geometry: %lld KB in %d KB pages\n", 
+                config->memoryCapacity, config->pageSize);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* add an input file, or every .txt file under a directory in name order, which makes the run a batch
+*/
+void addInputPath(Config* config, const char* path) {
+    struct stat info;
+    if (stat(path, &info) == 0 && S_ISDIR(info.st_mode)) {
+        DIR* directory = opendir(path);
+        if (directory == NULL) {
+            perror(path);
+            exit(EXIT_FAILURE);
+        }
+        config->batch = TRUE;
+
+        /* entries are collected first, so the batch order doesn't depend on the file system */
+        char (*entries)[MAX_PATH_LEN] = NULL;
+        int entryCount = 0, entryCapacity = 0;
+        size_t length = strlen(path);
+        while (length > 1 && path[length - 1] == '/') {
+            length--;
+        }
+        struct dirent* entry;
+        while ((entry = readdir(directory)) != NULL) {
+            if (entry->d_name[0] == '.') {
+                continue;
+            }
+            if (entryCount == entryCapacity) {
+                entryCapacity = (entryCapacity == 0) ? INITIAL_PROCESSES : entryCapacity * 2;
+                entries = realloc(entries, sizeof(*entries) * entryCapacity);
+                if (entries == NULL) {
+                    fprintf(stderr, "Realloc failure: Directory Entries not reallocated in memory\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            if (snprintf(entries[entryCount], MAX_PATH_LEN, "%.*s/%s", (int)length, path, entry->d_name) 
+                    >= MAX_PATH_LEN) {
+                fprintf(stderr, "Path too long: %s/%s\n", path, entry->d_name);
+                exit(EXIT_FAILURE);
+            }
+            entryCount++;
+        }
+        closedir(directory);
+
+        qsort(entries, entryCount, sizeof(*entries), compareFiles);
+        for (int i = 0; i < entryCount; i++) {
+            size_t nameLength = strlen(entries[i]);
+            if ((stat(entries[i], &info) == 0 && S_ISDIR(info.st_mode)) ||
+                    (nameLength > 4 && strcmp(entries[i] + nameLength - 4, ".txt") == 0)) {
+                addInputPath(config, entries[i]);
+            }
+        }
+        free(entries);
+        return;
+    }
+
+    if (config->fileCount == config->fileCapacity) {
+        config->fileCapacity = (config->fileCapacity == 0) ? INITIAL_PROCESSES : config->fileCapacity * 2;
+        config->files = realloc(config->files, sizeof(*config->files) * config->fileCapacity);
+        if (config->files == NULL) {
+            fprintf(stderr, "Realloc failure: Input Files not reallocated in memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (snprintf(config->files[config->fileCount], MAX_PATH_LEN, "%s", path) >= MAX_PATH_LEN) {
+        fprintf(stderr, "Path too long: %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    config->fileCount++;
+}
+
+int compareFiles(const void* a, const void* b) {
+    return strcmp((const char*)a, (const char*)b);
+}
+
+/* drop every input naming a file already in the list, whether it was repeated with -f,
+    spelled another way, or also found under a directory; the first keeps its place
+*/
+void removeDuplicateInputs(Config* config) {
+    InputFile* inputs = (InputFile*)malloc(sizeof(InputFile) * config->fileCount);
+    int* repeated = (int*)calloc(config->fileCount, sizeof(int));
+    if (inputs == NULL || repeated == NULL) {
+        fprintf(stderr, "Malloc failure: Input Files Not Checked\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* a path that can't be read is never a repeat here, and fails when its run opens it */
+    int count = 0;
+    struct stat info;
+    for (int i = 0; i < config->fileCount; i++) {
+        if (stat(config->files[i], &info) == 0) {
+            inputs[count].device = info.st_dev;
+            inputs[count].inode = info.st_ino;
+            inputs[count].index = i;
+            count++;
+        }
+    }
+    qsort(inputs, count, sizeof(InputFile), compareInputFiles);
+    for (int i = 1; i < count; i++) {
+        if (inputs[i].device == inputs[i - 1].device && inputs[i].inode == inputs[i - 1].inode) {
+            repeated[inputs[i].index] = TRUE;
+        }
+    }
+
+    int kept = 0;
+    for (int i = 0; i < config->fileCount; i++) {
+        if (!repeated[i]) {
+            if (kept != i) {
+                memcpy(config->files[kept], config->files[i], MAX_PATH_LEN);
+            }
+            kept++;
+        }
+    }
+    config->fileCount = kept;
+    free(inputs);
+    free(repeated);
+}
+
+/* order inputs by file, then by place in the list so the first of any repeats comes first */
+int compareInputFiles(const void* a, const void* b) {
+    const InputFile* left = (const InputFile*)a;
+    const InputFile* right = (const InputFile*)b;
+    if (left->device != right->device) {
+        return (left->device < right->device) ? -1 : 1;
+    }
+    if (left->inode != right->inode) {
+        return (left->inode < right->inode) ? -1 : 1;
+    }
+    return left->index - right->index;
+}
+
+/* distinct inputs can still be named onto one output file, such as a/b.txt and a_b.txt,
+    which two runs would truncate and write at once
+*/
+void checkOutputPaths(Config* config) {
+    char (*paths)[2 * MAX_PATH_LEN] = malloc(sizeof(*paths) * config->fileCount);
+    if (paths == NULL) {
+        fprintf(stderr, "Malloc failure: Output Paths Not Checked\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < config->fileCount; i++) {
+        outputPath(paths[i], config->outputDir, config->files[i]);
+    }
+    qsort(paths, config->fileCount, sizeof(*paths), compareFiles);
+    for (int i = 1; i < config->fileCount; i++) {
+        if (strcmp(paths[i], paths[i - 1]) == 0) {
+            fprintf(stderr, "Two batch inputs would both write %s\n", paths[i]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    free(paths);
+}
+
+/* read list of processes from file and store their info.
+    the file is mapped rather than read so records are parsed straight out of the page cache,
+    and the process table is sized up front from the number of lines
+*/
+Workload* readProcesses(char filename[]) {
+    Workload* workload = mapWorkload(filename);
+    const char* data = workload->data;
+    size_t size = workload->size;
+
+    /* one process per line, plus a last line without a newline */
+    size_t lines = 0;
+    for (const char* newline = data; size > 0 && 
+         (newline = memchr(newline, '\n', data + size - newline)) != NULL; newline++) {
+        lines++;
+    }
+    if (lines >= INT_MAX) {
+        fprintf(stderr, "%s: too many processes, use --stream\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    int curentSize = (int)lines + 1;
+    workload->processes = malloc(sizeof(Process) * curentSize);
+    if (workload->processes == NULL) {
+        fprintf(stderr, "Malloc failure: Process Array Not Initialized\n");
+        exit(EXIT_FAILURE);
+    }
+    growColumns(&workload->columns, curentSize);
+
+    /* reading processes into the table; a record never spans or shares a line, so the table never grows */
+    InputScanner* scanner = &workload->scanner;
+    while (skipWhitespace(scanner)) {
+        Process* process = &workload->processes[workload->processCount];
+        process->id = workload->processCount;
+        scanProcess(scanner, &workload->columns, process);
+        workload->processCount++;
+    }
+
+    /* every record has been copied out of the mapping */
+    if (size > 0) {
+        munmap((void*)data, size);
+    }
+    workload->data = NULL;
+    workload->size = 0;
+    return workload;
+}
+
+/* read one record into the process's columns and initialize the process structure
+*/
+void scanProcess(InputScanner* scanner, ProcessColumns* columns, Process* process) {
+    int id = process->id;
+    columns->arrivalTime[id] = scanInteger(scanner, "arrival time");
+    scanName(scanner, columns->processName[id]);
+    columns->serviceTime[id] = scanInteger(scanner, "service time");
+    columns->completionTime[id] = 0;
+    process->memoryRequirement = scanInteger(scanner, "memory requirement");
+    columns->priority[id] = scanOptionalInteger(scanner, "priority");
+    if (skipBlanks(scanner)) {
+        inputError(scanner, "expected the end of the line after", "priority");
+    }
+    process->remainingTime = columns->serviceTime[id];
+    process->state = READY;
+    process->FFmemoryAllocation = NOT_ALLOCATED;
+    process->PmemoryAllocation = NULL;
+    process->sizeOfFrames = 0;
+    process->residentFrames = 0;
+    process->lastUsed = NOT_ALLOCATED;
+    process->lruPrev = process->lruNext = NULL;
+    process->readyNext = NULL;
+    process->level = process->levelEpoch = 0;
+    process->levelUsed = 0;
+    process->firstRun = NOT_ALLOCATED;
+    process->preemptions = 0;
+}
+
+/* move past spaces and newlines, counting lines; FALSE once the input is exhausted
+*/
+int skipWhitespace(InputScanner* scanner) {
+    while (scanner->cursor < scanner->end && isspace((unsigned char)*scanner->cursor)) {
+        if (*scanner->cursor == '\n') {
+            scanner->line++;
+        }
+        scanner->cursor++;
+    }
+    return scanner->cursor < scanner->end;
+}
+
+/* move past spaces within the line; FALSE if the line or the input ends first
+*/
+int skipBlanks(InputScanner* scanner) {
+    while (scanner->cursor < scanner->end && (*scanner->cursor == ' ' || *scanner->cursor == '\t' || 
+                                              *scanner->cursor == '\r')) {
+        scanner->cursor++;
+    }
+    return scanner->cursor < scanner->end && *scanner->cursor != '\n';
+}
+
+/* report a malformed record, at the line it started on, and stop */
+void inputError(InputScanner* scanner, const char* message, const char* field) {
+    fprintf(stderr, "%s:%lld: %s %s\n", scanner->filename, scanner->line, message, field);
+    exit(EXIT_FAILURE);
+}
+
+/* a non-negative decimal field on the record's line */
+long long scanInteger(InputScanner* scanner, const char* field) {
+    if (!skipBlanks(scanner) || !isdigit((unsigned char)*scanner->cursor)) {
+        inputError(scanner, "expected a non-negative integer for", field);
+    }
+    long long value = 0;
+    while (scanner->cursor < scanner->end && isdigit((unsigned char)*scanner->cursor)) {
+        int digit = *scanner->cursor++ - '0';
+        if (value > (LLONG_MAX - digit) / 10) {
+            inputError(scanner, "integer out of range for", field);
+        }
+        value = value * 10 + digit;
+    }
+    if (scanner->cursor < scanner->end && !isspace((unsigned char)*scanner->cursor)) {
+        inputError(scanner, "unexpected character in", field);
+    }
+    return value;
+}
+
+/* a trailing field on the same line, 0 when the line ends first */
+long long scanOptionalInteger(InputScanner* scanner, const char* field) {
+    if (!skipBlanks(scanner)) {
+        return 0;
+    }
+    return scanInteger(scanner, field);
+}
+
+/* a process name of 1 to MAX_PROCESS_NAME_LEN - 1 characters on the record's line */
+void scanName(InputScanner* scanner, char name[]) {
+    if (!skipBlanks(scanner)) {
+        inputError(scanner, "expected a", "process name");
+    }
+    const char* start = scanner->cursor;
+    while (scanner->cursor < scanner->end && !isspace((unsigned char)*scanner->cursor)) {
+        scanner->cursor++;
+    }
+    size_t length = scanner->cursor - start;
+    if (length >= MAX_PROCESS_NAME_LEN) {
+        inputError(scanner, "too long (at most 8 characters):", "process name");
+    }
+    memcpy(name, start, length);
+    name[length] = '\0';
+}
+
+/* map the input file into a new, empty workload
+*/
+Workload* mapWorkload(char filename[]) {
+    Workload* workload = (Workload*)calloc(1, sizeof(Workload));
+    if (workload == NULL) {
+        fprintf(stderr, "Malloc failure: Workload Not Initialized\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* open file in read, exit if not found */
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        perror(filename);
+        exit(EXIT_FAILURE);
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        perror(filename);
+        exit(EXIT_FAILURE);
+    }
+
+    /* an empty file can't be mapped, and has no processes anyway */
+    workload->size = (size_t)info.st_size;
+    if (workload->size > 0) {
+        workload->data = mmap(NULL, workload->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (workload->data == MAP_FAILED) {
+            perror("mmap");
+            exit(EXIT_FAILURE);
+        }
+        madvise((void*)workload->data, workload->size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    InputScanner scanner = {workload->data, workload->data + workload->size, 1, filename};
+    workload->scanner = scanner;
+    return workload;
+}
+
+/* map the input for streaming and read its first record
+*/
+Workload* openStream(char filename[]) {
+    Workload* workload = mapWorkload(filename);
+    workload->streaming = TRUE;
+    readNextRecord(workload);
+    return workload;
+}
+
+void closeWorkload(Workload* workload) {
+    for (int i = 0; i < workload->chunkCount; i++) {
+        free(workload->chunks[i]);
+    }
+    free(workload->chunks);
+    free(workload->processes);
+    freeColumns(&workload->columns);
+    if (workload->size > 0) {
+        munmap((void*)workload->data, workload->size);
+    }
+    free(workload);
+}
+
+/* read the record after the one just admitted into a fresh slot, releasing the input pages behind it.
+    streams can't be sorted, so records have to already be in arrival order
 */
-void allocate(Process* processes, int processCount, int quantum, char memoryStrategy[]) {
-    ProcessQueue* processQueue = createQueue();
-    
-    /* Task 1: Round robin with Infinite Memory */
-    if(strcmp(INFINITE_MEMORY, memoryStrategy)== 0){
-        infiniteRR(processQueue, processes, processCount, quantum);
+void readNextRecord(Workload* workload) {
+    InputScanner* scanner = &workload->scanner;
+    long long previousArrival = (workload->next != NULL) ? workload->columns.arrivalTime[workload->next->id] : 0;
+    if (!skipWhitespace(scanner)) {
+        workload->next = NULL;
+        return;
     }
-    else if (strcmp(memoryStrategy, FIRST_FIT) == 0) {
-        int* memory = createMemory(memoryStrategy);
-        firstFitRR(processQueue, memory, processes, processCount, quantum);
-    }  
-    else if (strcmp(memoryStrategy, PAGED) == 0) {
-        int* pages = createMemory(memoryStrategy);
-        pagedMemoryRR(processQueue, pages, processes, processCount, quantum);
-        
+    workload->next = takeSlot(workload);
+    scanProcess(scanner, &workload->columns, workload->next);
+    if (workload->columns.arrivalTime[workload->next->id] < previousArrival) {
+        inputError(scanner, "streamed input must be sorted by", "arrival time");
     }
-    calculateStatistics(processes,processCount);
-
-    free(processQueue);
-    free(processes);
 
+    /* consumed pages are never read again, so they don't need to stay resident */
+    size_t consumed = scanner->cursor - workload->data;
+    if (consumed - workload->released >= STREAM_RELEASE_SIZE) {
+        size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+        size_t release = (consumed / pageSize) * pageSize;
+        madvise((void*)(workload->data + workload->released), release - workload->released, MADV_DONTNEED);
+        workload->released = release;
+    }
 }
-  
-
-void calculateStatistics(Process* processes, int processCount){
-    int total_time_turnaround = 0, avg_time_turnaround = 0;
-    double total_time_overhead = 0, max_time_overhead = 0, avg_time_overhead;
-    int makespan = 0;
-    for(int i = 0; i<processCount; i++){
-        
-        // Turnaround Time
-        total_time_turnaround += processes[i].completionTime - processes[i].arrivalTime;
-        
 
-        // Time Overhead
-        double time_overhead = (double)(processes[i].completionTime - 
-                                processes[i].arrivalTime)/processes[i].serviceTime;
-        total_time_overhead += time_overhead;
-        if(max_time_overhead<time_overhead){
-            max_time_overhead = time_overhead;
+/* a free slot for a streamed process, adding a chunk to the pool and its ids to the columns when none is left.
+    chunks never move, so queued and resident processes can be referred to by pointer
+*/
+Process* takeSlot(Workload* workload) {
+    if (workload->freeSlots == NULL) {
+        if (workload->chunkCount == workload->chunkCapacity) {
+            workload->chunkCapacity = (workload->chunkCapacity == 0) ? INITIAL_PROCESSES 
+                                                                     : workload->chunkCapacity * 2;
+            workload->chunks = (Process**)realloc(workload->chunks, sizeof(Process*) * workload->chunkCapacity);
         }
-
-        //Makespan
-        if(makespan < processes[i].completionTime){
-            makespan = processes[i].completionTime;
-        
+        Process* chunk = (Process*)malloc(sizeof(Process) * STREAM_CHUNK_PROCESSES);
+        if (workload->chunks == NULL || chunk == NULL) {
+            fprintf(stderr, "Malloc failure: Process Slots Not Allocated\n");
+            exit(EXIT_FAILURE);
+        }
+        int firstId = workload->chunkCount * STREAM_CHUNK_PROCESSES;
+        workload->chunks[workload->chunkCount++] = chunk;
+        growColumns(&workload->columns, firstId + STREAM_CHUNK_PROCESSES);
+        for (int i = STREAM_CHUNK_PROCESSES - 1; i >= 0; i--) {
+            chunk[i].id = firstId + i;
+            chunk[i].lruNext = workload->freeSlots;
+            workload->freeSlots = &chunk[i];
         }
-        
     }
+    Process* process = workload->freeSlots;
+    workload->freeSlots = process->lruNext;
+    return process;
+}
 
-    max_time_overhead = round(max_time_overhead*100)/100;
-    avg_time_turnaround = ceil((double)total_time_turnaround/processCount);
-    avg_time_overhead = round(total_time_overhead/processCount*100)/100;
+/* resize every column to hold capacity processes
+*/
+void growColumns(ProcessColumns* columns, int capacity) {
+    columns->arrivalTime = (long long*)realloc(columns->arrivalTime, sizeof(long long) * capacity);
+    columns->serviceTime = (long long*)realloc(columns->serviceTime, sizeof(long long) * capacity);
+    columns->completionTime = (long long*)realloc(columns->completionTime, sizeof(long long) * capacity);
+    columns->priority = (long long*)realloc(columns->priority, sizeof(long long) * capacity);
+    columns->processName = realloc(columns->processName, sizeof(*columns->processName) * capacity);
+    if (columns->arrivalTime == NULL || columns->serviceTime == NULL || 
+        columns->completionTime == NULL || columns->priority == NULL || columns->processName == NULL) {
+        fprintf(stderr, "Realloc failure: Process Columns not reallocated in memory\n");
+        exit(EXIT_FAILURE);
+    }
+    columns->capacity = capacity;
+}
 
-    printf("Turnaround time %d\n",avg_time_turnaround);
-    printf("Time overhead %.2f %.2f\n", max_time_overhead,avg_time_overhead );
-    printf("Makespan %d", makespan);
+void freeColumns(ProcessColumns* columns) {
+    free(columns->arrivalTime);
+    free(columns->serviceTime);
+    free(columns->completionTime);
+    free(columns->priority);
+    free(columns->processName);
 }
 
-/*******************************************************************************************************/
-/*Round-Robin Scheduling with Paged Memory Allocation
+/* whether the table is already in the order its processes are admitted under quantum;
+    a table in arrival order is in admission order under every quantum
 */
-void pagedMemoryRR(ProcessQueue* processQ, int* pages, Process* processes, int processCount, int quantum){
-    int time, finished, remaining;
-    time = finished = remaining = 0;
+int inAdmissionOrder(Workload* workload, int quantum) {
+    long long* arrival = workload->columns.arrivalTime;
+    for (int i = 1; i < workload->processCount; i++) {
+        if (admissionBoundary(arrival[i], quantum) < admissionBoundary(arrival[i - 1], quantum)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
 
-    while (finished < processCount){
-        // Checks if a new process can be added to the queue
-        checkProcesses(processQ, processes, processCount, time, &remaining, quantum);
+/* stable merge sort of the process table by the quantum boundary each process is admitted at,
+    so processes admitted together keep their file order even when their arrival times are out of order.
+    only an order of ids is sorted; the table and columns are then permuted into it once
+*/
+void sortByArrival(Workload* workload, int quantum) {
+    int processCount = workload->processCount;
+    long long* arrival = workload->columns.arrivalTime;
 
-        /*Takes the process at the head of the queue*/
-        Process* CPUproc;
-        if (processQ->head != NULL) {
-            CPUproc = (processQ->head->process);
-        } else {
-            //printf("t%d No Processes Queued\n", time);
-            time += quantum;
-            continue;
-        }
-        /* before running a process in CPU, check if it has allocated memory */
-        if (CPUproc->PmemoryAllocation == NULL || CPUproc->PmemoryAllocation[0] == NOT_ALLOCATED) {
-            CPUproc->PmemoryAllocation = allocatePages(pages, CPUproc->memoryRequirement, &CPUproc->sizeOfFrames);
-
-            /* if memory is still not allocated, evict least recently used pages of a processor
-               until enough memory is available */
-            if (CPUproc->PmemoryAllocation[0] == NOT_ALLOCATED) {
-                    while(CPUproc->PmemoryAllocation[0] == NOT_ALLOCATED){
-                        evictLRU(processCount,processes,pages,time);
-                        CPUproc->PmemoryAllocation = allocatePages(pages, CPUproc->memoryRequirement, 
-                                                                    &CPUproc->sizeOfFrames);
-                    }
-            }
-        }
-      
-        /* isNew flag determines whether the process in the CPU was switched from READY to RUNNING */
-        int isNew = FALSE;
+    /* input is normally already in arrival order */
+    if (inAdmissionOrder(workload, quantum)) {
+        return;
+    }
 
-        /* this is the first instruction call. It will determine what action to take for the quantum.
-            the instruction is either CONTINUE, FINISHED, or SWITCH*/
-        int instruction = update(CPUproc, quantum, &time, &finished, remaining, &isNew);
+    int* order = malloc(sizeof(int) * processCount);
+    int* buffer = malloc(sizeof(int) * processCount);
+    if (order == NULL || buffer == NULL) {
+        fprintf(stderr, "Malloc failure: Process Array Not Sorted\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < processCount; i++) {
+        order[i] = i;
+    }
 
-        /* if the process was NEW in the CPU, print out a message */
-        if (isNew) {
-            
-            int  remainingTime = CPUproc->serviceTime - CPUproc->cpuTimeUsed;
-            
-            int memUsage = calculatePageMemUsage(pages);
-           
-            printf("%d,RUNNING,process-name=%s,remaining-time=%d,mem-usage=%d%%,mem-frames=[", 
-                    /* decrement time in message in accordance with qunatum */
-                    (time - quantum), CPUproc->processName, (remainingTime + quantum), 
-                        memUsage);
-            CPUproc->lastUsed = time-quantum;
-
-            for(int i=0; i<CPUproc->sizeOfFrames;i++){
-                printf("%d",CPUproc->PmemoryAllocation[i]);
-                if(i<CPUproc->sizeOfFrames - 1){
-                    printf(",");
+    /* bottom-up merge of runs of doubling width */
+    int *from = order, *to = buffer;
+    for (int width = 1; width < processCount; width *= 2) {
+        for (int lo = 0; lo < processCount; lo += 2 * width) {
+            int mid = (lo + width < processCount) ? lo + width : processCount;
+            int hi = (lo + 2 * width < processCount) ? lo + 2 * width : processCount;
+            int left = lo, right = mid, k = lo;
+            while (left < mid && right < hi) {
+                /* take from the left run on ties to keep the sort stable */
+                if (admissionBoundary(arrival[from[right]], quantum) < admissionBoundary(arrival[from[left]], quantum)) {
+                    to[k++] = from[right++];
+                } else {
+                    to[k++] = from[left++];
                 }
             }
-
-            printf("]\n");
+            while (left < mid) {
+                to[k++] = from[left++];
+            }
+            while (right < hi) {
+                to[k++] = from[right++];
+            }
         }
+        int* swap = from;
+        from = to;
+        to = swap;
+    }
 
-        /* a CONTINUE call indicates that update() allowed the current CPUproc to run for a quantum.
-            if not, there is a call to switch out the current CPUproc
-            or that the process has FINISHED at the end of the quantum */
-        while (instruction != CONTINUE) {
-            Process* sendBack = dequeue(processQ);
-
-            /* if process is FINISHED, its serviceTime has been completed
-                and it can be removed from the queue */
-            if (sendBack->state == FINISHED) {
-                /* free the memory block allocated for the process */
-                printf("%d,EVICTED,evicted-frames=[",time);
-                for(int i=0; i<sendBack->sizeOfFrames;i++){
-                    printf("%d",sendBack->PmemoryAllocation[i]);
-                    if(i<sendBack->sizeOfFrames - 1){
-                        printf(",");
-                    }
-                }
-                    printf("]\n");
-
-                deallocatePages(pages, &sendBack->sizeOfFrames, sendBack->PmemoryAllocation);
+    /* gather the table and every column into sorted order; ids follow the new positions */
+    Process* processes = malloc(sizeof(Process) * processCount);
+    ProcessColumns columns = {NULL, NULL, NULL, NULL, NULL, 0};
+    if (processes == NULL) {
+        fprintf(stderr, "Malloc failure: Process Array Not Sorted\n");
+        exit(EXIT_FAILURE);
+    }
+    growColumns(&columns, processCount);
+    for (int i = 0; i < processCount; i++) {
+        int id = from[i];
+        processes[i] = workload->processes[id];
+        processes[i].id = i;
+        columns.arrivalTime[i] = workload->columns.arrivalTime[id];
+        columns.serviceTime[i] = workload->columns.serviceTime[id];
+        columns.completionTime[i] = workload->columns.completionTime[id];
+        columns.priority[i] = workload->columns.priority[id];
+        memcpy(columns.processName[i], workload->columns.processName[id], MAX_PROCESS_NAME_LEN);
+    }
+    free(workload->processes);
+    freeColumns(&workload->columns);
+    workload->processes = processes;
+    workload->columns = columns;
 
-                remaining--;
-                printf("%d,FINISHED,process-name=%s,proc-remaining=%d\n", time, sendBack->processName, remaining);
-                sendBack->completionTime = time;
-        
-                /* continue as idle if no other processes are queued*/
-                if (remaining == 0) {
-                    break;
-                }
+    free(order);
+    free(buffer);
+}
 
-            /* if instructions is SWITCH, 
-                which means that the current process has already run the last quantum, 
-                AND there are also other processes READY,
-                the CPU will switch out the process and send the current one to the back. */
-            } else if (instruction == SWITCH) {
-                sendBack->lastUsed = time;
-                sendBack->state = READY;
-                enqueue(processQ, sendBack);
-            } 
-
-            /* select the new process to run in the CPU */
-            CPUproc = processQ->head->process;  
-
-            /* in the case that a NEW process is in the CPU, but it has not been allocated memory.. */
-            if (CPUproc->PmemoryAllocation == NULL || CPUproc->PmemoryAllocation[0] == NOT_ALLOCATED) {
-                CPUproc->PmemoryAllocation = allocatePages(pages, CPUproc->memoryRequirement, &CPUproc->sizeOfFrames);
-
-            /* if memory is still not allocated, evict least recently used pages of a processor
-               until there is enough memory for the current processor */
-                if (CPUproc->PmemoryAllocation[0] == NOT_ALLOCATED) {
-                    while(CPUproc->PmemoryAllocation[0] == NOT_ALLOCATED){
-                        evictLRU(processCount,processes,pages,time);
-                        CPUproc->PmemoryAllocation = allocatePages(pages, CPUproc->memoryRequirement, 
-                                                                    &CPUproc->sizeOfFrames);
-                    }
-                }
-            }
+/* arrivals are only admitted at the end of the quantum they fall in */
+long long admissionBoundary(long long arrivalTime, int quantum) {
+    return ((arrivalTime + quantum - 1) / quantum) * quantum;
+}
 
-            /* This update call will only be done IF a new process is now in the CPU
-                or the current process is allowed to continue, given no other ready processes, 
-                AND the process has been allocated memory */
-            instruction = update(CPUproc, quantum, &time, &finished, remaining, &isNew);
+/* Process Queue Functions 
 
-            /* if the process was NEW in the CPU, print out a message */
-            if (isNew) {
-                int  remainingTime = CPUproc->serviceTime - CPUproc->cpuTimeUsed;
-                int memUsage = calculatePageMemUsage(pages);
-           
-                printf("%d,RUNNING,process-name=%s,remaining-time=%d,mem-usage=%d%%,mem-frames=[", 
-                    /* decrement time in message in accordance with qunatum */
-                    (time - quantum), CPUproc->processName, (remainingTime + quantum), 
-                        memUsage);
+    Ring buffer of processes; the buffer doubles when full
+    and is otherwise reused for the whole simulation
+*/
+ProcessQueue* createQueue(Arena* arena) {
+    ProcessQueue* q = (ProcessQueue*)arenaAlloc(arena, sizeof(ProcessQueue));
+    q->slots = (Process**)arenaAlloc(arena, sizeof(Process*) * INITIAL_PROCESSES);
+    q->capacity = INITIAL_PROCESSES;
+    q->head = q->size = 0;
+    q->arena = arena;
+    return q;
+}
 
-            CPUproc->lastUsed = time-quantum;
+/* place a process at the end of the CPU queue
+*/
+void enqueue(ProcessQueue* processQueue, Process* process) {
+    if (processQueue->size == processQueue->capacity) {
+        Process** slots = (Process**)arenaAlloc(processQueue->arena, sizeof(Process*) * processQueue->capacity * 2);
 
-                for(int i=0; i<CPUproc->sizeOfFrames;i++){
-                    printf("%d",CPUproc->PmemoryAllocation[i]);
-                    if(i<CPUproc->sizeOfFrames - 1){
-                        printf(",");
-                    }
-                }
-                printf("]\n");
-            }
-        }    
+        /* unwrap the ring into the front of the larger buffer */
+        for (int i = 0; i < processQueue->size; i++) {
+            slots[i] = processQueue->slots[(processQueue->head + i) % processQueue->capacity];
+        }
+        processQueue->slots = slots;
+        processQueue->capacity *= 2;
+        processQueue->head = 0;
     }
-    for(int i=0; i<processCount;i++){
-        free(processes[i].PmemoryAllocation);
+    int tail = (processQueue->head + processQueue->size) % processQueue->capacity;
+    processQueue->slots[tail] = process;
+    processQueue->size++;
+}
+
+/* take the process currently running in the CPU
+*/
+Process* dequeue(ProcessQueue* processQueue) {
+    if (processQueue->size == 0) {
+        fprintf(stderr, "Queue Empty\n");
+        exit(EXIT_FAILURE);
     }
-    free(pages);
+    Process* process = processQueue->slots[processQueue->head];
+    processQueue->head = (processQueue->head + 1) % processQueue->capacity;
+    processQueue->size--;
+    return process;
 }
 
-/* Round-Robin Scheduling with First-Fit Memory Allocation
+/* the process at the head of the queue, considered to be in the CPU
 */
-void firstFitRR(ProcessQueue* processQ, int* memory, Process* processes, int processCount, int quantum) {
-    int time, finished, remaining;
-    time = finished = remaining = 0;
+Process* front(ProcessQueue* processQueue) {
+    if (processQueue->size == 0) {
+        return NULL;
+    }
+    return processQueue->slots[processQueue->head];
+}
 
-    /* loop will run until all processes are FINISHED*/
-    while (finished < processCount) {
-    
-        /* check if any new processes need to added to the queue */
-        checkProcesses(processQ, processes, processCount, time, &remaining, quantum);
-        
-        /* take the process at the head of the queue,
-            this process is now considered in the CPU */
-        Process* CPUproc;
-        if (processQ->head != NULL) {
-            CPUproc = (processQ->head->process);
-        } else {
-            time += quantum;
-            continue;
-        }
+/*******************************************************************************************************/
+/* Run Index Functions
 
-        /* before running a process in CPU, check if has allocated memory */
-        while (CPUproc->FFmemoryAllocation == NOT_ALLOCATED) {
-            CPUproc->FFmemoryAllocation = allocateMemoryBlock(memory, CPUproc->memoryRequirement);
+    Treap of the rr run queue ordered by position, where every node caches the least memory
+    any process in its subtree still needs. Taking the first process that fits is one descent,
+    and passing the ones before it over to the back of the queue is a split and a merge, both O(log n)
+*/
+RunIndex* createRunIndex(Arena* arena) {
+    RunIndex* index = (RunIndex*)arenaAlloc(arena, sizeof(RunIndex));
+    index->arena = arena;
+    index->nodes = NULL;
+    index->nodeCount = index->nodeCapacity = 0;
+    index->freeNode = NOT_ALLOCATED;
+    index->root = NOT_ALLOCATED;
+    index->seed = 2463534242u;
+    return index;
+}
 
-            /* if memory is still not allocated, deque process and move to back of the queue */
-            if (CPUproc->FFmemoryAllocation == NOT_ALLOCATED) {
-                Process* sendBack = dequeue(processQ);
-                enqueue(processQ, sendBack);
-                CPUproc = processQ->head->process;
-            }
+/* take a node from the pool, growing it if every node is in use */
+int newRunIndexNode(RunIndex* index, Process* process, long long need) {
+    int node = index->freeNode;
+    if (node != NOT_ALLOCATED) {
+        index->freeNode = index->nodes[node].left;
+    } else {
+        if (index->nodeCount == index->nodeCapacity) {
+            int capacity = (index->nodeCapacity == 0) ? INITIAL_PROCESSES : index->nodeCapacity * 2;
+            index->nodes = arenaGrow(index->arena, index->nodes, sizeof(RunIndexNode) * index->nodeCapacity, 
+                                     sizeof(RunIndexNode) * capacity);
+            index->nodeCapacity = capacity;
         }
+        node = index->nodeCount++;
+    }
 
-        /* isNew flag determines whether the process in the CPU was switched from READY to RUNNING */
-        int isNew = FALSE;
-
-        /* this is the first instruction call. It will determine what action to take for the quantum.
-            the instruction is either CONTINUE, FINISHED, or SWITCH*/
-        int instruction = update(CPUproc, quantum, &time, &finished, remaining, &isNew);
-
-        /* if the process was NEW in the CPU, print out a message */
-        if (isNew) {
-            int  remainingTime = CPUproc->serviceTime - CPUproc->cpuTimeUsed;
-            int memUsage = calculateMemUsage(memory);
-            printf("%d,RUNNING,process-name=%s,remaining-time=%d,mem-usage=%d%%,allocated-at=%d\n", 
-                    /* decrement time in message in accordance with qunatum */
-                    (time - quantum), CPUproc->processName, (remainingTime + quantum), 
-                        memUsage, CPUproc->FFmemoryAllocation);
-        }
-
-        /* a CONTINUE call indicates that update() allowed the current CPUproc to run for a quantum.
-            if not, there is a call to switch out the current CPUproc
-            or that the process has FINISHED at the end of the quantum */
-        while (instruction != CONTINUE) {
-            Process* sendBack = dequeue(processQ);
-
-            /* if process is FINISHED, its serviceTime has been completed
-                and it can be removed from the queue */
-            if (sendBack->state == FINISHED) {
-                /* free the memory block allocated for the process */
-                deallocateMemoryBlock(memory, sendBack->FFmemoryAllocation, sendBack->memoryRequirement);
-
-                remaining--;
-                printf("%d,FINISHED,process-name=%s,proc-remaining=%d\n", time, sendBack->processName, remaining);
-                sendBack->completionTime = time;
-        
-                /* continue as idlle if no other processes are queued*/
-                if (remaining == 0) {
-                    break;
-                }
-
-            /* if instructions is SWITCH, 
-                which means that the current process has already run the last quantum, 
-                AND there are also other processes READY,
-                the CPU will switch out the process and send the current one to the back. */
-            } else if (instruction == SWITCH) {
-                sendBack->state = READY;
-                enqueue(processQ, sendBack);
-            } 
-
-            /* select the new process to run in the CPU */
-            CPUproc = processQ->head->process;  
-
-            /* in the case that a NEW process is in the CPU, but it has not been allocated memory.. */
-            while (CPUproc->FFmemoryAllocation == NOT_ALLOCATED) {
-                /* allocate memory for new process */
-                CPUproc->FFmemoryAllocation = allocateMemoryBlock(memory, CPUproc->memoryRequirement);
-
-                /* if memory is still not allocated, dequeue process and move to back of the queue,
-                    continue until the current CPUproc has memory allocated, allowing it to RUN */
-                if (CPUproc->FFmemoryAllocation == NOT_ALLOCATED) {
-                    Process* sendBack = dequeue(processQ);
-                    enqueue(processQ, sendBack);
-                    CPUproc = processQ->head->process;
-                } 
-            }
+    index->seed ^= index->seed << 13;
+    index->seed ^= index->seed >> 17;
+    index->seed ^= index->seed << 5;
 
-            /* This update call will only be done IF a new process is now in the CPU
-                or the current is allowed to continue, given no other ready processes, 
-                AND the process has been allocated memory */
-            instruction = update(CPUproc, quantum, &time, &finished, remaining, &isNew);
+    RunIndexNode* entry = &index->nodes[node];
+    entry->process = process;
+    entry->need = entry->smallest = need;
+    entry->count = 1;
+    entry->priority = index->seed;
+    entry->left = entry->right = NOT_ALLOCATED;
+    return node;
+}
 
-            /* if the process was NEW in the CPU, print out a message */
-            if (isNew) {
-                int  remainingTime = CPUproc->serviceTime - CPUproc->cpuTimeUsed;
-                int memUsage = calculateMemUsage(memory);
-                printf("%d,RUNNING,process-name=%s,remaining-time=%d,mem-usage=%d%%,allocated-at=%d\n", 
-                        /* decrement time in message in accordance with quantum */
-                        (time - quantum), CPUproc->processName, (remainingTime + quantum), 
-                            memUsage, CPUproc->FFmemoryAllocation);
+/* recompute the size and least need below a node after its children changed */
+void updateRunIndexNode(RunIndex* index, int node) {
+    RunIndexNode* entry = &index->nodes[node];
+    entry->smallest = entry->need;
+    entry->count = 1;
+    for (int i = 0; i < 2; i++) {
+        int child = (i == 0) ? entry->left : entry->right;
+        if (child != NOT_ALLOCATED) {
+            entry->count += index->nodes[child].count;
+            if (index->nodes[child].smallest < entry->smallest) {
+                entry->smallest = index->nodes[child].smallest;
             }
-        }    
+        }
     }
 }
 
-/*Evict pages of least recently used processor
-*/
-void evictLRU(int processCount, Process* processes, int* memory, int time){
-    int least_recent = 0;
-    for(int i=0; i<processCount; i++){
-        if(processes[i].state != FINISHED && processes[i].lastUsed >= 0){
-            if(processes[i].lastUsed < least_recent){
-                least_recent = i;
-            }
-        }
+/* join two treaps where every process in left is ahead of every process in right */
+int mergeRunIndex(RunIndex* index, int left, int right) {
+    if (left == NOT_ALLOCATED) {
+        return right;
     }
-    printf("%d,EVICTED,evicted-frames=[",time);
-    for(int i=0; i<processes[least_recent].sizeOfFrames;i++){
-        printf("%d",processes[least_recent].PmemoryAllocation[i]);
-        if(i<processes[least_recent].sizeOfFrames - 1){
-            printf(",");
-        }
+    if (right == NOT_ALLOCATED) {
+        return left;
     }
-    printf("]\n");
+    if (index->nodes[left].priority > index->nodes[right].priority) {
+        index->nodes[left].right = mergeRunIndex(index, index->nodes[left].right, right);
+        updateRunIndexNode(index, left);
+        return left;
+    }
+    index->nodes[right].left = mergeRunIndex(index, left, index->nodes[right].left);
+    updateRunIndexNode(index, right);
+    return right;
+}
 
-    deallocatePages(memory,&processes[least_recent].sizeOfFrames,
-        processes[least_recent].PmemoryAllocation);
+/* split a treap into its first count processes and the rest */
+void splitRunIndex(RunIndex* index, int node, int count, int* left, int* right) {
+    if (node == NOT_ALLOCATED) {
+        *left = *right = NOT_ALLOCATED;
+        return;
+    }
+    int before = (index->nodes[node].left == NOT_ALLOCATED) ? 0 : index->nodes[index->nodes[node].left].count;
+    if (before < count) {
+        splitRunIndex(index, index->nodes[node].right, count - before - 1, &index->nodes[node].right, right);
+        *left = node;
+    } else {
+        splitRunIndex(index, index->nodes[node].left, count, left, &index->nodes[node].left);
+        *right = node;
+    }
+    updateRunIndexNode(index, node);
 }
 
+/* place a process at the end of the run queue */
+void appendRunIndex(RunIndex* index, Process* process, long long need) {
+    index->root = mergeRunIndex(index, index->root, newRunIndexNode(index, process, need));
+}
 
-/* calculate percentage of total memory used, rounded up
+/* take the first process needing at most limit KB, moving every process ahead of it to the back of the queue
+    in order, as trying each in turn would; NULL, leaving the queue as it was, if none fits
 */
-int calculateMemUsage(int* memory) {
-    double usage = 0;
-    for (int i = 0; i < MEMORY_CAPACITY; i++) {
-        if (memory[i] == ALLOCATED) {
-            usage++;
-        }
+Process* takeRunIndex(RunIndex* index, long long limit) {
+    if (index->root == NOT_ALLOCATED || index->nodes[index->root].smallest > limit) {
+        return NULL;
     }
-    usage = ceil((usage / MEMORY_CAPACITY) * 100);
 
-    return (int)usage;
-}
-
-int calculatePageMemUsage(int* pages) {
-    double usage = 0;
-    for (int i = 0; i < NUM_PAGES; i++) {
-        if (pages[i] == ALLOCATED) {
-            usage++;
+    /* count the processes ahead of the first that fits */
+    int position = 0;
+    int node = index->root;
+    while (TRUE) {
+        RunIndexNode* entry = &index->nodes[node];
+        if (entry->left != NOT_ALLOCATED && index->nodes[entry->left].smallest <= limit) {
+            node = entry->left;
+        } else if (entry->need <= limit) {
+            position += (entry->left == NOT_ALLOCATED) ? 0 : index->nodes[entry->left].count;
+            break;
+        } else {
+            position += ((entry->left == NOT_ALLOCATED) ? 0 : index->nodes[entry->left].count) + 1;
+            node = entry->right;
         }
     }
-    usage = ceil((usage / NUM_PAGES) * 100);
 
-    return (int)usage;
+    int ahead, taken, behind;
+    splitRunIndex(index, index->root, position, &ahead, &behind);
+    splitRunIndex(index, behind, 1, &taken, &behind);
+    index->root = mergeRunIndex(index, behind, ahead);
+    index->nodes[taken].left = index->freeNode;
+    index->freeNode = taken;
+    return index->nodes[taken].process;
 }
 
-/* Free the block of memory associate with a process 
-*/
-void deallocateMemoryBlock(int* memory, int allocationStart, int allocationSize) {
-    for (int i = allocationStart; i < (allocationStart + allocationSize); i++) {
-        memory[i] = FREE;
+/* the process at the front of the run queue */
+Process* firstRunIndex(RunIndex* index) {
+    int node = index->root;
+    if (node == NOT_ALLOCATED) {
+        return NULL;
     }
-}
-
-/*Free the pages associate with a process */
-void deallocatePages(int* memory, int* frameSize, int* frames){
-    int free_page_number = 0;
-    for(int i=0; i< *frameSize; i++){
-        free_page_number = frames[i];
-        memory[free_page_number] = FREE;
-        frames[i] = NOT_ALLOCATED;
+    while (index->nodes[node].left != NOT_ALLOCATED) {
+        node = index->nodes[node].left;
     }
-    
+    return index->nodes[node].process;
 }
 
-/* Allocate a contiguous block of memory for a process
-*/    
-int allocateMemoryBlock(int* memory, int memoryRequirement) {
-    
-    int freeBlockSize = 0, memoryAllocation = NOT_ALLOCATED;
-
-    /* scan through memory block to check for a fit */
-    for (int i = 0; i < MEMORY_CAPACITY; i++) {
-        if (memory[i] == FREE) {
-            freeBlockSize++;
-            /* if there is space, mark the start index of memory block */
-            if (freeBlockSize == memoryRequirement) {
-                memoryAllocation = i - memoryRequirement + 1;
-                /* mark the block as allocated memory */
-                for (int j = memoryAllocation; j <= i; j++) {
-                    memory[j] = ALLOCATED;
-                }
-            }
-        /* if a memory space is already ALLOCATED and freeBlocksize < memoryREQ,
-            reset search */
-        } else {
-            freeBlockSize = 0;
-        }
-    }
-    return memoryAllocation;
+int runIndexSize(RunIndex* index) {
+    return (index->root == NOT_ALLOCATED) ? 0 : index->nodes[index->root].count;
 }
-// Allocates pages for a process
-int* allocatePages(int* memory, int memoryRequirement, int* frameSize) {
 
-    int freeBlockSize = 0, memoryAllocation = NOT_ALLOCATED;
-    int pagesRequired = 0;
-
-    // Allocate memory into pages
-    if(memoryRequirement % PAGE_SIZE == 0 ){
-        pagesRequired = memoryRequirement/PAGE_SIZE;
-    } else{
-        pagesRequired = (memoryRequirement/PAGE_SIZE) + 1;
-    }
+/*******************************************************************************************************/
+/* Scheduler Functions
 
-    *frameSize = pagesRequired;
-    int* frames = (int*) calloc(pagesRequired, sizeof(int));
-    if (frames == NULL) {
-        fprintf(stderr, "Failed to allocate memory block\n");
+    every policy is driven through the same calls from the RR loops:
+    makeReady when a process arrives or is switched out, runningProcess / takeRunning for the CPU,
+    and shouldPreempt / runLimit from update() to decide when the running process gives up the CPU
+*/
+Scheduler* createScheduler(Arena* arena, char policy[], int quantum, ProcessColumns* columns, int sizedMemory) {
+    Scheduler* scheduler = (Scheduler*)arenaAlloc(arena, sizeof(Scheduler));
+    if (strcmp(policy, ROUND_ROBIN) == 0) {
+        scheduler->policy = POLICY_RR;
+    } else if (strcmp(policy, SHORTEST_JOB_FIRST) == 0) {
+        scheduler->policy = POLICY_SJF;
+    } else if (strcmp(policy, SHORTEST_REMAINING_TIME) == 0) {
+        scheduler->policy = POLICY_SRTF;
+    } else if (strcmp(policy, PRIORITY_AGING) == 0) {
+        scheduler->policy = POLICY_PRIORITY;
+    } else if (strcmp(policy, MULTILEVEL_FEEDBACK) == 0) {
+        scheduler->policy = POLICY_MLFQ;
+    } else {
+        fprintf(stderr, "Unknown scheduling policy: %s\n", policy);
         exit(EXIT_FAILURE);
     }
+    scheduler->quantum = quantum;
+    scheduler->queue = createQueue(arena);
+    scheduler->index = (scheduler->policy == POLICY_RR && sizedMemory) ? createRunIndex(arena) : NULL;
+    scheduler->heap.arena = arena;
+    scheduler->deferred.arena = arena;
+    scheduler->columns = columns;
+    scheduler->arena = arena;
+    scheduler->nextBoost = (long long)MLFQ_BOOST_QUANTA * quantum;
+    return scheduler;
+}
 
-    // Initialize the frames
-    for(int i = 0; i< pagesRequired ; i++){
-        frames[i] = NOT_ALLOCATED;
-    }
-
-    /* scan through memory block to check for a fit */
-    for (int i = 0; i < NUM_PAGES; i++) {
-        if (memory[i] == FREE) {
-            freeBlockSize++;
-            /* if there is space, mark the start index of memory block */
-            if (freeBlockSize == pagesRequired) {
-                memoryAllocation = i - pagesRequired + 1;
-                /* mark the block as allocated memory */
-                for (int j = memoryAllocation; j <= i; j++) {
-                    if(memory[j] != ALLOCATED){
-                        memory[j] = ALLOCATED;
-
-                        // mark the frames used by the processor
-                        for(int k=0; k<pagesRequired; k++){
-                            if(frames[k] == NOT_ALLOCATED){
-                                frames[k] = j;
-                                //printf("%d,",j);
-                                break;
-                            }
-                        }
-                    }
-                }
+/* a process becomes READY: rr appends it to the run queue, sjf and srtf key it by remaining time,
+    priority by its priority in aging steps plus the time it started waiting,
+    which orders waiting processes by aged priority without ever updating their keys
+*/
+void makeReady(Scheduler* scheduler, Process* process, long long time) {
+    switch (scheduler->policy) {
+        case POLICY_RR:
+            if (scheduler->index != NULL) {
+                appendRunIndex(scheduler->index, process, 
+                               (process->FFmemoryAllocation == NOT_ALLOCATED) ? process->memoryRequirement : 0);
+            } else {
+                enqueue(scheduler->queue, process);
             }
-        /* if a memory space is already ALLOCATED and freeBlocksize < memoryREQ,
-            reset search */
-        } else {
-            freeBlockSize = 0;
+            break;
+        case POLICY_SJF:
+        case POLICY_SRTF:
+            pushHeap(&scheduler->heap, process->remainingTime, process);
+            break;
+        case POLICY_PRIORITY:
+            pushHeap(&scheduler->heap, scheduler->columns->priority[process->id] * PRIORITY_AGING_TIME + time, process);
+            break;
+        case POLICY_MLFQ: {
+            boostLevels(scheduler, time);
+            ReadyList* list = &scheduler->levels[currentLevel(scheduler, process)];
+            process->readyNext = NULL;
+            if (list->tail == NULL) {
+                list->head = process;
+            } else {
+                list->tail->readyNext = process;
+            }
+            list->tail = process;
+            list->size++;
+            break;
         }
     }
-    return frames;
 }
 
-/* Allocation of memory;
-    memory is treated as an integer array of size 2048 KB 512KB and each element is 1KB of memory,
-    OR integer array of size 512KB,
-    where 0 indicates a free spot and 1 indicates an allocated space
+/* the process in the CPU, picking the next READY one when the CPU is free; NULL if there is none
 */
-int* createMemory(char memoryStrategy[]) {
-    int memorySize = 0;
-    if(strcmp(memoryStrategy, FIRST_FIT) == 0){
-        memorySize = MEMORY_CAPACITY;
-    } else{
-        memorySize = NUM_PAGES;
+Process* runningProcess(Scheduler* scheduler) {
+    if (scheduler->running == NULL) {
+        scheduler->running = pickNext(scheduler);
     }
-    int* memory = (int*) calloc(memorySize, sizeof(int));
-    if (memory == NULL) {
-        fprintf(stderr, "Failed to allocate memory block\n");
-        exit(EXIT_FAILURE);
-    }
-    return memory;
+    return scheduler->running;
 }
 
-/*******************************************************************************************************/
-
-/* Round-Robin Scheduling with Infinite Memory */
-void infiniteRR(ProcessQueue* processQ, Process* processes, int processCount, int quantum) {
-    int time, finished, remaining;
-    time = finished = remaining = 0;
-
-    while (finished < processCount) {
-
-        /* check if any new processes need to added to the queue */
-        checkProcesses(processQ, processes, processCount, time, &remaining,quantum);
-
-        /* take the process at the head of the queue,
-            this process is now considered in the CPU */
-        Process* CPUproc;
-        if (processQ->head != NULL) {
-            CPUproc = (processQ->head->process);
-        } 
-        /* if there are no READY processes in the queue,
-            the CPU will run idle for another quantum */
-        else {
-            time += quantum;
-            continue;
-        }
-
-        /* this is the first instruction call. It will determine what action to take for the quantum.
-            the instruction is either CONTINUE, FINISHED, or SWITCH*/
-        int isNew = FALSE;
-        int instruction = update(CPUproc, quantum, &time, &finished, remaining, &isNew);
+/* take the process out of the CPU, to be FINISHED, switched out or deferred
+*/
+Process* takeRunning(Scheduler* scheduler) {
+    Process* process = runningProcess(scheduler);
+    scheduler->running = NULL;
+    return process;
+}
 
-        /* if the process was NEW in the CPU, print out a message */
-        if (isNew) {
-            int  remainingTime = CPUproc->serviceTime - CPUproc->cpuTimeUsed;
-            printf("%d,RUNNING,process-name=%s,remaining-time=%d\n", 
-                    /* decrement time in message in accordance with qunatum */
-                    (time - quantum), CPUproc->processName, (remainingTime + quantum));
-        }
-
-        /* a CONTINUE call indicates that update() allowed the current CPUproc to run for a quantum.
-            if not, there is a call to switch out the current CPUproc */
-        while (instruction != CONTINUE) {
-            Process* sendBack = dequeue(processQ);
-
-            /* if process is FINISHED, its serviceTime has been completed
-                and it can be removed from the queue */
-            if (sendBack->state == FINISHED) {
-                remaining--;
-                printf("%d,FINISHED,process-name=%s,proc-remaining=%d\n", time, sendBack->processName, remaining);
-                sendBack->completionTime = time;
-            
-                /* continue as idlle if no other processes are queued*/
-                if (remaining == 0) {
-                    break;
+Process* pickNext(Scheduler* scheduler) {
+    switch (scheduler->policy) {
+        case POLICY_RR:
+            if (scheduler->index != NULL) {
+                return takeRunIndex(scheduler->index, LLONG_MAX);
+            }
+            return (scheduler->queue->size > 0) ? dequeue(scheduler->queue) : NULL;
+        case POLICY_MLFQ:
+            for (int level = 0; level < MLFQ_LEVELS; level++) {
+                ReadyList* list = &scheduler->levels[level];
+                if (list->head != NULL) {
+                    Process* process = list->head;
+                    list->head = process->readyNext;
+                    if (list->head == NULL) {
+                        list->tail = NULL;
+                    }
+                    list->size--;
+                    return process;
                 }
-
-            /* if instructions is SWITCH, 
-                which means that the current process has already run the last quantum, 
-                AND there are also other processes READY,
-                the CPU will switch out the process and send the current one to the back. */
-            } else if (instruction == SWITCH) {
-                sendBack->state = READY;
-                enqueue(processQ, sendBack);
             }
+            return NULL;
+        default:
+            return popHeap(&scheduler->heap);
+    }
+}
 
-            /* This update call will only be done IF a new process is now in the CPU */
-            CPUproc = processQ->head->process;
-            instruction = update(CPUproc, quantum, &time, &finished, remaining, &isNew);
-
-            /* if the process was NEW in the CPU, print out a message */
-            if (isNew) {
-                int  remainingTime = CPUproc->serviceTime - CPUproc->cpuTimeUsed;
-                printf("%d,RUNNING,process-name=%s,remaining-time=%d\n", 
-                    /* decrement time in message in accordance with qunatum */
-                    (time - quantum), CPUproc->processName, (remainingTime + quantum));
+int readyProcesses(Scheduler* scheduler) {
+    switch (scheduler->policy) {
+        case POLICY_RR:
+            return (scheduler->index != NULL) ? runIndexSize(scheduler->index) : scheduler->queue->size;
+        case POLICY_MLFQ: {
+            int size = 0;
+            for (int level = 0; level < MLFQ_LEVELS; level++) {
+                size += scheduler->levels[level].size;
             }
-        } 
+            return size;
+        }
+        default:
+            return scheduler->heap.size;
     }
 }
 
-/*******************************************************************************************************/
+/* every process the scheduler holds: READY, deferred, and the one in the CPU */
+int scheduledProcesses(Scheduler* scheduler) {
+    return readyProcesses(scheduler) + scheduler->deferred.size + (scheduler->running != NULL);
+}
 
-/* standard update function. Runs the CPU process for ONE time unit
+/* at the end of a quantum, whether the running process should be SWITCHed out.
+    rr switches whenever anything else is READY and sjf never does; srtf and priority switch
+    when the best READY process beats the running one. mlfq demotes a process that used up
+    its level's allotment and then round robins within the level, and always lets a higher level in
 */
-int update(Process* CPUproc, int quantum, int* time, int* finished, int remaining, int* isNew) {
-    /* check whether the current CPU process has just entered, 
-        or if it was already running */
-    if (CPUproc->state == READY) {
-        CPUproc->state = RUNNING;
-        /* mark the process as NEW as up to this point, 
-            the current CPU process was only considered a candidate */
-        *isNew = TRUE;
+int shouldPreempt(Scheduler* scheduler, Process* process, long long time) {
+    switch (scheduler->policy) {
+        case POLICY_RR:
+            return readyProcesses(scheduler) > 0;
+        case POLICY_SJF:
+            return FALSE;
+        case POLICY_SRTF:
+            return scheduler->heap.size > 0 && scheduler->heap.entries[0].key < process->remainingTime;
+        case POLICY_PRIORITY:
+            return scheduler->heap.size > 0 && 
+                   scheduler->heap.entries[0].key - time < scheduler->columns->priority[process->id] * PRIORITY_AGING_TIME;
+        default: {
+            boostLevels(scheduler, time);
+            int level = currentLevel(scheduler, process);
+            int expired = process->levelUsed >= levelAllotment(scheduler, level);
+            if (expired) {
+                if (level < MLFQ_LEVELS - 1) {
+                    process->level = ++level;
+                }
+                process->levelUsed = 0;
+            }
+            /* after an expired allotment the process also yields to its own level */
+            int lowest = expired ? level : level - 1;
+            for (int higher = 0; higher <= lowest; higher++) {
+                if (scheduler->levels[higher].size > 0) {
+                    return TRUE;
+                }
+            }
+            return FALSE;
+        }
     }
+}
 
-    /* check if quantum has elapsed for RUNNING process, 
-        since process switching and completion can ONLY be performed at the end of a quantum.
-        isNew indiciates whether a process has already run for a quantum or not */
-    if ((CPUproc->state == RUNNING) && (!(*isNew))) {
-        /* if at the end of a quantum, a processes CPUtime has passed its serviceTime,
-            it is FINISHED */
-        if (CPUproc->cpuTimeUsed >= CPUproc->serviceTime) {
-            CPUproc->state = FINISHED;
-            (*finished)++;
-            return FINISHED;
-        } 
-        /* if a process has already run for a quantum and there are other READY processes in the queue,
-            the process must be SWITCHed out */
-        else if (remaining > 1) { 
-            return SWITCH;
-        } 
+/* how long the running process can keep the CPU before the policy might preempt it,
+    if nothing arrives in the meantime, or NO_EVENT if only its completion or an arrival can
+*/
+long long runLimit(Scheduler* scheduler, Process* process, long long time) {
+    if (scheduler->policy == POLICY_PRIORITY && scheduler->heap.size > 0) {
+        /* the best waiting process keeps aging until it overtakes the running one */
+        return scheduler->heap.entries[0].key - scheduler->columns->priority[process->id] * PRIORITY_AGING_TIME + 1 - time;
+    } else if (scheduler->policy == POLICY_MLFQ) {
+        long long limit = scheduler->nextBoost - time;
+        int level = currentLevel(scheduler, process);
+        /* a process alone on the last level has nothing left to be demoted to or switched with */
+        if (level < MLFQ_LEVELS - 1 || readyProcesses(scheduler) > 0) {
+            long long allotment = levelAllotment(scheduler, level) - process->levelUsed;
+            if (allotment < limit) {
+                limit = allotment;
+            }
+        }
+        return limit;
     }
+    return NO_EVENT;
+}
 
-    /* run the process for ONE quantum. 
-        this will run ONLY if the process isNew
-        or if there are no other processes in the queue */
-    if ((CPUproc->state == RUNNING)) {
-        /* increment CPU time used and totalTime by quantum */
-        CPUproc->cpuTimeUsed += quantum;
-        (*time) += quantum;  
+/* account for time the running process spent in the CPU. a slice only runs past the allotment
+    when the process is alone on the last level, where each allotment it used up would have started a new one
+*/
+void chargeRun(Scheduler* scheduler, Process* process, long long slice) {
+    if (scheduler->policy == POLICY_MLFQ) {
+        long long allotment = levelAllotment(scheduler, currentLevel(scheduler, process));
+        process->levelUsed = (process->levelUsed + slice - 1) % allotment + 1;
     }
+}
 
-    return CONTINUE;
-} 
-
-/* Check for READY processes according to arrival time
+/* a process that doesn't fit in memory yet. rr moves it to the back of the run queue as before;
+    other policies would pick it straight back, so it waits aside, smallest first, until memory is freed
 */
-void checkProcesses(ProcessQueue* processQ, Process* processes, int processCount, int time, int* remaining, int quantum) {
-
-    /* check if any processes are ready to enque based on arrival time */
-    for (int i = 0; i < processCount; i++) {
-        /* in the case that arrival time is not a multiple of the quantum,
-            test if current time has overtaken arrival time,
-            but only enque if arrival time was in between the current quantum and the previous */
-        if ((processes[i].arrivalTime <= time) && (processes[i].arrivalTime > (time-quantum))) {
-            enqueue(processQ, &processes[i]);
-            (*remaining)++;
-        }
+void deferProcess(Scheduler* scheduler, Process* process, long long time) {
+    if (scheduler->policy == POLICY_RR) {
+        makeReady(scheduler, process, time);
+    } else {
+        pushHeap(&scheduler->deferred, process->memoryRequirement, process);
     }
-}  
+}
 
-/*******************************************************************************************************/
-// Basic pre-task HELPER FUNCTIONS
-/* read command line arguments to deterimine:
-    list of processes, memory strategy, & quantum length
+/* make READY again the smallest deferred processes needing at most largest KB, the most any process
+    could be given now, while together they fit in room, the memory left free. the others could not all
+    be given memory at once and wait for the next free, so a free costs O(log n) per process it lets through
+    and lets through no more than the free memory can hold
 */
-void readInput(int argc, char* argv[], char filename[], char memoryStrategy[], int* quantum){
-    for (int i = 1; i < argc - 1; i++) {
-        /* filename */
-        if (strcmp(argv[i], "-f") == 0) {
-            strcpy(filename, argv[++i]);
-        /* memory strategy (infinite, first-fit, paged, virtual)*/
-        } else if (strcmp(argv[i], "-m") == 0) {
-            strcpy(memoryStrategy, argv[++i]);
-        /* quantum length (1, 2, 3)*/
-        } else if (strcmp(argv[i], "-q") == 0) {
-            *quantum = atoi(argv[++i]);
+int releaseDeferred(Scheduler* scheduler, long long time, long long largest, long long* room) {
+    int released = 0;
+    while (scheduler->deferred.size > 0 && scheduler->deferred.entries[0].key <= largest &&
+            scheduler->deferred.entries[0].key <= *room) {
+        if (*room != LLONG_MAX) {
+            *room -= scheduler->deferred.entries[0].key;
         }
+        makeReady(scheduler, popHeap(&scheduler->deferred), time);
+        released++;
     }
+    return released;
 }
 
-/* read list of processes from file and store their info
+/* binary min-heap on (key, sequence), so equal keys leave in the order they were pushed
 */
-Process* readProcesses(char filename[], int* processCount) {
-    /* open file in read, exit if not found */
-    FILE *fp = fopen(filename, "r");
-    if (fp == NULL) {
-        perror("fopen");
-        exit(EXIT_FAILURE);
+void pushHeap(ProcessHeap* heap, long long key, Process* process) {
+    if (heap->size == heap->capacity) {
+        int capacity = (heap->capacity == 0) ? INITIAL_PROCESSES : heap->capacity * 2;
+        heap->entries = arenaGrow(heap->arena, heap->entries, sizeof(HeapEntry) * heap->capacity,
+                                  sizeof(HeapEntry) * capacity);
+        heap->capacity = capacity;
+    }
+    HeapEntry entry = {key, heap->sequence++, process};
+    int child = heap->size++;
+    while (child > 0) {
+        int parent = (child - 1) / 2;
+        HeapEntry* above = &heap->entries[parent];
+        if (above->key < key || (above->key == key && above->sequence < entry.sequence)) {
+            break;
+        }
+        heap->entries[child] = *above;
+        child = parent;
     }
+    heap->entries[child] = entry;
+}
 
-    /* Initialization of dynamic array to store processes */
-    size_t curentSize = INITIAL_PROCESSES;
-    Process *processes = malloc(sizeof(Process) * curentSize);
-    if (processes == NULL) {
-        fprintf(stderr, "Malloc failure: Process Array Not Initialized\n");
-        exit(EXIT_FAILURE);
+Process* popHeap(ProcessHeap* heap) {
+    if (heap->size == 0) {
+        return NULL;
     }
-    *processCount = 0;
-
-    /* reading processes into the array */
-    int arrival, serviceTime, memoryReq;
-    char* name = malloc(sizeof(char) * MAX_PROCESS_NAME_LEN);
-    while (fscanf(fp, "%d %s %d %d", &arrival, name, &serviceTime, &memoryReq) == 4) {
-        /* reallocate memory if needed */
-        if (*processCount == curentSize) {
-            curentSize *= 2;
-            processes = realloc(processes, sizeof(Process) * curentSize);
-            if (processes == NULL) {
-                fprintf(stderr, "Realloc failure: Process Array not reallocated in memory\n");
-                exit(EXIT_FAILURE);
-            }
+    Process* process = heap->entries[0].process;
+    HeapEntry last = heap->entries[--heap->size];
+    int parent = 0;
+    while (TRUE) {
+        int child = 2 * parent + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        HeapEntry* entries = heap->entries;
+        if (child + 1 < heap->size && (entries[child + 1].key < entries[child].key || 
+            (entries[child + 1].key == entries[child].key && entries[child + 1].sequence < entries[child].sequence))) {
+            child++;
+        }
+        if (last.key < entries[child].key || (last.key == entries[child].key && last.sequence < entries[child].sequence)) {
+            break;
         }
-        
-        /* Initialize process structure */
-        processes[*processCount].arrivalTime = arrival;
-        strcpy(processes[*processCount].processName, name);
-        processes[*processCount].serviceTime = serviceTime;
-        processes[*processCount].memoryRequirement = memoryReq;
-        processes[*processCount].state = READY;
-        processes[*processCount].cpuTimeUsed = READY;
-        processes[*processCount].FFmemoryAllocation = NOT_ALLOCATED;
-        processes[*processCount].PmemoryAllocation = NULL;
-        processes[*processCount].sizeOfFrames = 0;
-        processes[*processCount].lastUsed = NOT_ALLOCATED;
-        processes[*processCount].completionTime = 0;
-        (*processCount)++;
+        entries[parent] = entries[child];
+        parent = child;
     }
-
-    free(name);
-
-    fclose(fp);
-    return processes;
+    if (heap->size > 0) {
+        heap->entries[parent] = last;
+    }
+    return process;
 }
 
-/* Process Queue Functions 
-
-    Based on basic queue implentation using linked lists on
-    https://www.geeksforgeeks.org/queue-linked-list-implementation/
-*/
-ProcessNode* newProcessNode(Process* process) {
-    ProcessNode* temp = (ProcessNode*)malloc(sizeof(ProcessNode));
-    temp->process = process;
-    temp->next = NULL;
-    return temp;
+/* a process's mlfq level; a level from before the last boost is reset to the top */
+int currentLevel(Scheduler* scheduler, Process* process) {
+    if (process->levelEpoch != scheduler->epoch) {
+        process->level = 0;
+        process->levelUsed = 0;
+        process->levelEpoch = scheduler->epoch;
+    }
+    return process->level;
 }
 
-ProcessQueue* createQueue() {
-    ProcessQueue* q = (ProcessQueue*)malloc(sizeof(ProcessQueue));
-    q->head = q->tail = NULL;
-    return q;
+/* time a process may run at a level before it is demoted */
+long long levelAllotment(Scheduler* scheduler, int level) {
+    return (long long)scheduler->quantum << level;
 }
 
-/* place a process at the end of the CPU queue
+/* move every process back to the top level once a boost is due,
+    by starting a new epoch and appending the lower levels to the top list in order
 */
-void enqueue(ProcessQueue* processQueue, Process* process) {
-    ProcessNode* temp = newProcessNode(process);
-    if (processQueue->tail == NULL) {
-        processQueue->head = processQueue->tail = temp;
+void boostLevels(Scheduler* scheduler, long long time) {
+    if (scheduler->policy != POLICY_MLFQ || time < scheduler->nextBoost) {
         return;
     }
-    processQueue->tail->next = temp;
-    processQueue->tail = temp;
-}
-/* take the process currently running in the CPU
-*/
-Process* dequeue(ProcessQueue* processQueue) {
-    if (processQueue->head == NULL) {
-        printf("Queue Empty\n");
-        exit(EXIT_FAILURE);
-    }
-    ProcessNode* temp = processQueue->head;
-    Process* process = temp->process;
-    processQueue->head = processQueue->head->next;
-    if (processQueue->head == NULL) {
-        processQueue->tail = NULL;
+    long long period = (long long)MLFQ_BOOST_QUANTA * scheduler->quantum;
+    scheduler->nextBoost = (time / period + 1) * period;
+    scheduler->epoch++;
+
+    ReadyList* top = &scheduler->levels[0];
+    for (int level = 1; level < MLFQ_LEVELS; level++) {
+        ReadyList* list = &scheduler->levels[level];
+        if (list->head == NULL) {
+            continue;
+        }
+        if (top->tail == NULL) {
+            top->head = list->head;
+        } else {
+            top->tail->readyNext = list->head;
+        }
+        top->tail = list->tail;
+        top->size += list->size;
+        list->head = list->tail = NULL;
+        list->size = 0;
     }
-    free(temp);
-    return process;
-}
\ No newline at end of file
+}
@@ -0,0 +1,46 @@
+#!/bin/sh
+# Scale benchmark: generates seeded workloads of increasing size and runs every
+# memory strategy on each, reporting events simulated, wall time and peak RSS.
+# The default workload leaves memory mostly free, so each size is generated again
+# overloaded (OVERLOAD, passed to generate) and run under every scheduling policy,
+# where blocked processes pile up in the ready queues.
+# Override the sizes with SCALES="1000 1000000" make bench; virtual memory replaces
+# pages by REPLACEMENT (lru, fifo, clock or opt)
+SCALES=${SCALES:-"1000 10000 100000"}
+# every memory strategy allocate accepts for -m; keep in step with allocate()
+STRATEGIES=${STRATEGIES:-"infinite first-fit buddy paged virtual"}
+# every scheduling policy allocate accepts for -s; keep in step with createScheduler()
+POLICIES=${POLICIES:-"rr sjf srtf priority mlfq"}
+OVERLOAD=${OVERLOAD:-"-a poisson:1 -m uniform:200:1500"}
+REPLACEMENT=${REPLACEMENT:-lru}
+QUANTUM=${QUANTUM:-3}
+SEED=${SEED:-1}
+TRACE=${TMPDIR:-/tmp}/allocate-bench-$$.txt
+
+trap 'rm -f "$TRACE"' EXIT
+
+# run workload policy strategy scale: one row of the table for the current trace
+run() {
+    options=""
+    if [ "$3" = virtual ]; then
+        options="--replacement $REPLACEMENT"
+    fi
+    result=$(./allocate -f "$TRACE" -m "$3" -s "$2" -q "$QUANTUM" $options --bench 2>&1 > /dev/null) || exit 1
+    printf "%-10s %-8s %-10s %10s %s\n" "$1" "$2" "$3" "$4" "$result"
+}
+
+printf "%-10s %-8s %-10s %10s %s\n" workload policy strategy processes result
+for scale in $SCALES; do
+    ./generate -n "$scale" -s "$SEED" > "$TRACE" || exit 1
+    for strategy in $STRATEGIES; do
+        run default rr "$strategy" "$scale"
+    done
+done
+for scale in $SCALES; do
+    ./generate -n "$scale" -s "$SEED" $OVERLOAD > "$TRACE" || exit 1
+    for policy in $POLICIES; do
+        for strategy in $STRATEGIES; do
+            run overloaded "$policy" "$strategy" "$scale"
+        done
+    done
+done
@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+/*******************************************************************************************************/
+// List of Constants
+
+/* Standard True/False Flags*/
+#define TRUE 1
+#define FALSE 0
+
+/* Process names are P followed by the process number in base 36,
+    keeping them within the 8 uppercase alphanumeric characters allocate accepts */
+#define MAX_PROCESS_NAME_LEN 9
+#define NAME_DIGITS "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+#define MAX_SPEC_LEN 100
+
+/* Supported distributions */
+#define CONSTANT "const"
+#define UNIFORM "uniform"
+#define EXPONENTIAL "exp"
+#define PARETO "pareto"
+
+/* Supported arrival processes */
+#define POISSON "poisson"
+#define BATCH "batch"
+
+/* Defaults, sized so the workload fits the default 2048 KB of memory */
+#define DEFAULT_PROCESSES 1000
+#define DEFAULT_SEED 1
+#define DEFAULT_ARRIVAL "poisson:25"
+#define DEFAULT_SERVICE "uniform:1:40"
+#define DEFAULT_MEMORY "uniform:1:512"
+#define DEFAULT_MAX_MEMORY 2048
+
+/*******************************************************************************************************/
+/* Distribution
+    a parsed spec such as uniform:1:40 or pareto:5:1.5
+*/
+typedef struct {
+    char kind[MAX_SPEC_LEN];
+    double a, b;
+} Distribution;
+
+/*******************************************************************************************************/
+// List of Functions
+
+/* Pre-Task Functions */
+void readInput(int argc, char* argv[], long long* processCount, uint64_t* seed,
+               char arrival[], char service[], char memory[], long long* maxMemory);
+Distribution parseDistribution(char spec[]);
+
+/* Sampling Functions */
+uint64_t nextRandom(uint64_t* state);
+double nextUniform(uint64_t* state);
+double sample(Distribution* distribution, uint64_t* state);
+long long sampleAtLeastOne(Distribution* distribution, uint64_t* state, long long max);
+
+/* Output Functions */
+void processName(long long index, char name[]);
+
+/*******************************************************************************************************/
+/* Synthetic workload generator: writes processes in allocate's input format,
+    <arrival> <name> <service> <memory>, in arrival order.
+    The same seed and specs always give the same workload
+*/
+int main(int argc, char* argv[]) {
+    long long processCount = DEFAULT_PROCESSES, maxMemory = DEFAULT_MAX_MEMORY;
+    uint64_t seed = DEFAULT_SEED;
+    char arrivalSpec[MAX_SPEC_LEN] = DEFAULT_ARRIVAL;
+    char serviceSpec[MAX_SPEC_LEN] = DEFAULT_SERVICE;
+    char memorySpec[MAX_SPEC_LEN] = DEFAULT_MEMORY;
+
+    readInput(argc, argv, &processCount, &seed, arrivalSpec, serviceSpec, memorySpec, &maxMemory);
+
+    Distribution arrival = parseDistribution(arrivalSpec);
+    Distribution service = parseDistribution(serviceSpec);
+    Distribution memory = parseDistribution(memorySpec);
+
+    /* the generator state must never be zero */
+    uint64_t state = seed ^ 0x9E3779B97F4A7C15ull;
+    if (state == 0) {
+        state = 1;
+    }
+
+    char name[MAX_PROCESS_NAME_LEN];
+    long long time = 0;
+    for (long long i = 0; i < processCount; i++) {
+        /* poisson arrivals have exponential gaps with the given mean,
+            batch arrivals release a.a processes together every a.b time units */
+        if (strcmp(arrival.kind, POISSON) == 0) {
+            Distribution gap = {EXPONENTIAL, arrival.a, 0};
+            time += (long long)floor(sample(&gap, &state));
+        } else if (strcmp(arrival.kind, BATCH) == 0) {
+            if (i > 0 && i % (long long)arrival.a == 0) {
+                time += (long long)arrival.b;
+            }
+        } else {
+            time += (long long)floor(sample(&arrival, &state));
+        }
+
+        processName(i, name);
+        printf("%lld %s %lld %lld\n", time, name, sampleAtLeastOne(&service, &state, 0),
+               sampleAtLeastOne(&memory, &state, maxMemory));
+    }
+
+    return 0;
+}
+
+/*******************************************************************************************************/
+// Sampling Functions
+/* xorshift64* generator, used instead of rand() so workloads are identical on every platform
+*/
+uint64_t nextRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+/* uniform in [0, 1) from the top 53 bits */
+double nextUniform(uint64_t* state) {
+    return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* draw one value:
+    const:v, uniform:min:max (inclusive), exp:mean, pareto:min:alpha (heavy tailed)
+*/
+double sample(Distribution* distribution, uint64_t* state) {
+    if (strcmp(distribution->kind, CONSTANT) == 0) {
+        return distribution->a;
+    } else if (strcmp(distribution->kind, UNIFORM) == 0) {
+        return distribution->a + floor(nextUniform(state) * (distribution->b - distribution->a + 1));
+    } else if (strcmp(distribution->kind, EXPONENTIAL) == 0) {
+        return -distribution->a * log(1.0 - nextUniform(state));
+    } else if (strcmp(distribution->kind, PARETO) == 0) {
+        return distribution->a / pow(1.0 - nextUniform(state), 1.0 / distribution->b);
+    }
+    fprintf(stderr, "Unknown distribution: %s\n", distribution->kind);
+    exit(EXIT_FAILURE);
+}
+
+/* service times and memory sizes are positive integers, memory is capped by max when max > 0 */
+long long sampleAtLeastOne(Distribution* distribution, uint64_t* state, long long max) {
+    long long value = (long long)ceil(sample(distribution, state));
+    if (value < 1) {
+        value = 1;
+    }
+    if (max > 0 && value > max) {
+        value = max;
+    }
+    return value;
+}
+
+/*******************************************************************************************************/
+// Basic pre-task HELPER FUNCTIONS
+/* read command line arguments to determine:
+    number of processes, seed, arrival process, service time and memory distributions
+*/
+void readInput(int argc, char* argv[], long long* processCount, uint64_t* seed,
+               char arrival[], char service[], char memory[], long long* maxMemory) {
+    for (int i = 1; i < argc - 1; i++) {
+        /* number of processes */
+        if (strcmp(argv[i], "-n") == 0) {
+            *processCount = atoll(argv[++i]);
+        /* random seed */
+        } else if (strcmp(argv[i], "-s") == 0) {
+            *seed = strtoull(argv[++i], NULL, 10);
+        /* arrival process (poisson:mean-gap, batch:size:gap, or a gap distribution) */
+        } else if (strcmp(argv[i], "-a") == 0) {
+            snprintf(arrival, MAX_SPEC_LEN, "%s", argv[++i]);
+        /* service time distribution */
+        } else if (strcmp(argv[i], "-t") == 0) {
+            snprintf(service, MAX_SPEC_LEN, "%s", argv[++i]);
+        /* memory requirement distribution in KB */
+        } else if (strcmp(argv[i], "-m") == 0) {
+            snprintf(memory, MAX_SPEC_LEN, "%s", argv[++i]);
+        /* largest memory requirement in KB, 0 for no limit */
+        } else if (strcmp(argv[i], "-M") == 0) {
+            *maxMemory = atoll(argv[++i]);
+        }
+    }
+}
+
+/* split a kind:a:b spec into its parts
+*/
+Distribution parseDistribution(char spec[]) {
+    Distribution distribution = {"", 0, 0};
+    char* separator = strchr(spec, ':');
+    size_t kindLength = (separator == NULL) ? strlen(spec) : (size_t)(separator - spec);
+    memcpy(distribution.kind, spec, kindLength);
+    distribution.kind[kindLength] = '\0';
+
+    if (separator != NULL) {
+        char* end;
+        distribution.a = strtod(separator + 1, &end);
+        if (*end == ':') {
+            distribution.b = strtod(end + 1, NULL);
+        }
+    }
+    if (strcmp(distribution.kind, BATCH) == 0 && distribution.a < 1) {
+        fprintf(stderr, "Batch arrivals need a size of at least 1: %s\n", spec);
+        exit(EXIT_FAILURE);
+    }
+    return distribution;
+}
+
+/* P followed by the index in base 36 */
+void processName(long long index, char name[]) {
+    char digits[MAX_PROCESS_NAME_LEN];
+    int count = 0;
+    do {
+        digits[count++] = NAME_DIGITS[index % 36];
+        index /= 36;
+    } while (index > 0 && count < MAX_PROCESS_NAME_LEN - 2);
+
+    name[0] = 'P';
+    for (int i = 0; i < count; i++) {
+        name[i + 1] = digits[count - 1 - i];
+    }
+    name[count + 1] = '\0';
+}